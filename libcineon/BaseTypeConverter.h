@@ -40,6 +40,79 @@
 namespace cineon
 {
 	// convert between all of the DPX base types in a controllable way
+	// integer components use their full range, R32 components are normalized to 0.0 - 1.0
+	// and clamped to that range when converted back to integers
+
+	// IEEE 754 single to half precision, rounding to nearest even
+	inline U16 FloatToHalf(const R32 value)
+	{
+		union { R32 f; U32 u; } v;
+		v.f = value;
+
+		const U32 sign = (v.u >> 16) & 0x8000;
+		const U32 bits = v.u & 0x7fffffff;
+
+		// infinity and nan
+		if (bits >= 0x7f800000)
+			return U16(sign | 0x7c00 | (bits > 0x7f800000 ? 0x200 : 0));
+
+		// too large, rounds to infinity
+		if (bits >= 0x477ff000)
+			return U16(sign | 0x7c00);
+
+		// denormalized half
+		if (bits < 0x38800000)
+		{
+			if (bits < 0x33000000)
+				return U16(sign);
+
+			const U32 mantissa = (bits & 0x7fffff) | 0x800000;
+			const int shift = 126 - int(bits >> 23);
+			U32 h = mantissa >> shift;
+			const U32 rest = mantissa & ((1U << shift) - 1);
+			const U32 halfway = 1U << (shift - 1);
+			if (rest > halfway || (rest == halfway && (h & 1)))
+				h++;
+			return U16(sign | h);
+		}
+
+		U32 h = (bits - 0x38000000) >> 13;
+		const U32 rest = bits & 0x1fff;
+		if (rest > 0x1000 || (rest == 0x1000 && (h & 1)))
+			h++;
+		return U16(sign | h);
+	}
+
+	// IEEE 754 half to single precision
+	inline R32 HalfToFloat(const U16 value)
+	{
+		union { R32 f; U32 u; } v;
+
+		const U32 sign = U32(value & 0x8000) << 16;
+		const U32 exponent = (value >> 10) & 0x1f;
+		U32 mantissa = value & 0x3ff;
+
+		if (exponent == 0x1f)
+			v.u = sign | 0x7f800000 | (mantissa << 13);
+		else if (exponent)
+			v.u = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		else if (mantissa == 0)
+			v.u = sign;
+		else
+		{
+			// denormalized half, normalize it
+			int e = 113;
+			while ((mantissa & 0x400) == 0)
+			{
+				mantissa <<= 1;
+				e--;
+			}
+			v.u = sign | (U32(e) << 23) | ((mantissa & 0x3ff) << 13);
+		}
+
+		return v.f;
+	}
+
 
 	inline void BaseTypeConverter(U8 &src, U8 &dst)
 	{
@@ -63,7 +136,7 @@ namespace cineon
 
 	inline void BaseTypeConverter(U8 &src, R32 &dst)
 	{
-		dst = src;
+		dst = src * (1.0f / 0xff);
 	}
 
 	inline void BaseTypeConverter(U8 &src, R64 &dst)
@@ -93,7 +166,7 @@ namespace cineon
 
 	inline void BaseTypeConverter(U16 &src, R32 &dst)
 	{
-		dst = src;
+		dst = src * (1.0f / 0xffff);
 	}
 
 	inline void BaseTypeConverter(U16 &src, R64 &dst)
@@ -123,7 +196,7 @@ namespace cineon
 
 	inline void BaseTypeConverter(U32 &src, R32 &dst)
 	{
-		dst = src;
+		dst = R32(src * (1.0 / 0xffffffffU));
 	}
 
 	inline void BaseTypeConverter(U32 &src, R64 &dst)
@@ -153,7 +226,7 @@ namespace cineon
 
 	inline void BaseTypeConverter(U64 &src, R32 &dst)
 	{
-		dst = src;
+		dst = R32(src * (1.0 / 18446744073709551615.0));
 	}
 
 	inline void BaseTypeConverter(U64 &src, R64 &dst)
@@ -163,22 +236,22 @@ namespace cineon
 
 	inline void BaseTypeConverter(R32 &src, U8 &dst)
 	{
-		dst = src;
+		dst = (src > 0.0f ? (src < 1.0f ? U8(src * 0xff + 0.5f) : 0xff) : 0);
 	}
 
 	inline void BaseTypeConverter(R32 &src, U16 &dst)
 	{
-		dst = src;
+		dst = (src > 0.0f ? (src < 1.0f ? U16(src * 0xffff + 0.5f) : 0xffff) : 0);
 	}
 
 	inline void BaseTypeConverter(R32 &src, U32 &dst)
 	{
-		dst = src;
+		dst = (src > 0.0f ? (src < 1.0f ? U32(src * 4294967295.0 + 0.5) : 0xffffffffU) : 0);
 	}
 
 	inline void BaseTypeConverter(R32 &src, U64 &dst)
 	{
-		dst = src;
+		dst = (src > 0.0f ? (src < 1.0f ? U64(src * 18446744073709551615.0) : ~U64(0)) : 0);
 	}
 
 	inline void BaseTypeConverter(R32 &src, R32 &dst)
@@ -221,6 +294,28 @@ namespace cineon
 		dst = src;
 	}
 
+	// R16 converts through R32
+
+	template <typename T>
+	inline void BaseTypeConverter(T &src, R16 &dst)
+	{
+		R32 value;
+		BaseTypeConverter(src, value);
+		dst.bits = FloatToHalf(value);
+	}
+
+	template <typename T>
+	inline void BaseTypeConverter(R16 &src, T &dst)
+	{
+		R32 value = HalfToFloat(src.bits);
+		BaseTypeConverter(value, dst);
+	}
+
+	inline void BaseTypeConverter(R16 &src, R16 &dst)
+	{
+		dst = src;
+	}
+
 }
 
 #endif
@@ -61,6 +61,7 @@ namespace cineon
 	// forward definitions
 	class Codec;
 	class ElementReadStream;
+	struct LogEncoding;
 
 	/*!
 	 * \enum Endian
@@ -73,6 +74,65 @@ namespace cineon
 	};
 
 
+	/*!
+	 * \enum PixelFormat
+	 * \brief Layout of the pixels in a Reader::ReadBlock() buffer
+	 */
+	enum PixelFormat
+	{
+		kComponents,								//!< a component of the buffer's data size for each channel
+		kA2R10G10B10,								//!< 32-bit word, alpha in the 2 most significant bits, then red, green and blue in 10 bits each
+		kR10G10B10A2								//!< 32-bit word, red in the 10 least significant bits, then green, blue and alpha in the 2 most significant bits
+	};
+
+
+	/*!
+	 * \enum ResampleFilter
+	 * \brief Filters of Reader::ReadResampled()
+	 */
+	enum ResampleFilter
+	{
+		kMitchell,									//!< Mitchell-Netravali cubic with B = C = 1/3, little ringing
+		kLanczos3									//!< Lanczos windowed sinc over 3 lobes, sharper
+	};
+
+
+	/*!
+	 * \struct BufferType
+	 * \brief Data size of the components of a typed buffer
+	 *
+	 * Defined for U8, U16, U32, U64, R32 and R16 components.
+	 */
+	template <typename T>
+	struct BufferType;
+
+	template <> struct BufferType<U8> { static const DataSize size = kByte; };
+	template <> struct BufferType<U16> { static const DataSize size = kWord; };
+	template <> struct BufferType<U32> { static const DataSize size = kInt; };
+	template <> struct BufferType<U64> { static const DataSize size = kLongLong; };
+	template <> struct BufferType<R32> { static const DataSize size = kFloat; };
+	template <> struct BufferType<R16> { static const DataSize size = kHalf; };
+
+
+	/*! \struct Span
+	 * \brief Buffer of count components of type T
+	 */
+	template <typename T>
+	struct Span
+	{
+		T *data;										//!< first component
+		size_t count;									//!< number of components
+
+		/*!
+		 * \brief Constructor
+		 *
+		 * \param data first component
+		 * \param count number of components
+		 */
+		inline Span(T *data, const size_t count);
+	};
+
+
 	/*! \struct Block
 	 * \brief Rectangle block definition defined by two points
 	 */
@@ -121,6 +181,184 @@ namespace cineon
 	};
 
 
+	/*! \struct ReadOptions
+	 * \brief Layout of the destination buffer and conversions for Reader::ReadBlock()
+	 *
+	 * The defaults describe a tightly packed buffer, the layout Reader::ReadImage() uses,
+	 * without any conversion.
+	 *
+	 * The alpha option adds one component after the image's own ones to every pixel, set to
+	 * alphaValue, so a three element image reads as RGBA.  Without a pixel stride the pixels are
+	 * then tightly packed with the extra component, otherwise the pixel stride has to leave room
+	 * for it and be a multiple of the component size.  A pixel stride larger than the pixel
+	 * alone leaves the rest of each pixel untouched.
+	 *
+	 * The channels list the image components stored in the pixels of the buffer, in order, so
+	 * {2, 1, 0} reads an RGB image as BGR, or BGRA with the alpha, and {1} reads the green
+	 * component alone.  Components that are not listed are not converted.  The colour matrix
+	 * and the 3D lookup table work on the image's components before they are reordered.
+	 *
+	 * The 10:10:10:2 pixel formats pack three channels and a 2-bit alpha, taken from alphaValue,
+	 * into a 32-bit word of the host's byte order for each pixel.  The buffer's data size has to
+	 * be kInt, lookup tables hold kWord entries and the alpha option and planar buffers are not
+	 * available.  Three element 10-bit filled images without any conversion are repacked straight
+	 * from the words of the file.
+	 *
+	 * Proxies read the block at a half, a quarter or an eighth of its resolution, keeping the
+	 * first of every proxy lines and, unless proxyAverage is set, the first of every proxy
+	 * pixels of those lines, the other lines are not read at all.  With proxyAverage each run
+	 * of proxy pixels is averaged instead.  The buffer holds (x2 - x1) / proxy + 1 pixels by
+	 * (y2 - y1) / proxy + 1 lines.
+	 *
+	 * With orient set the pixels come out left to right, top to bottom, whatever the orientation
+	 * of the image, and the block is given in those coordinates, within Header::Width() by
+	 * Header::Height().  Images stored with reversed lines or pixels are decoded into the buffer
+	 * from its end, images stored top to bottom or bottom to top are decoded a band of lines at
+	 * a time and transposed into the buffer in tiles.  Without it the pixels and the block are
+	 * in the order of the file, Header::StoredWidth() by Header::StoredHeight().
+	 *
+	 * Planar buffers are given as one plane per component, and one more for the alpha, the
+	 * data pointer given to Reader::ReadBlock() is then ignored.  The row pitch and pixel stride
+	 * apply to every plane, the pixel stride defaults to the component size and has to be a
+	 * multiple of it.
+	 *
+	 * The log to linear conversion maps the printing density code values through
+	 * (10^((code - white) * d / gamma) - 10^((black - white) * d / gamma)) / (1 - 10^((black - white) * d / gamma)),
+	 * d being the density step of a 10-bit code value taken from the element's low and high data and
+	 * quantity (0.002 if the header leaves them undefined), so reference black becomes 0.0 and
+	 * reference white 1.0. Reference black has to be below reference white.
+	 *
+	 * Lookup tables replace each component by the table entry of its code value, they hold
+	 * 1 << bit depth entries (1024 for 10-bit images, 4096 for 12-bit) of the buffer component type,
+	 * which has to be kByte, kWord, kFloat or kHalf.  An image element without a table of its own
+	 * uses the first element's table, which it needs the bit depth of, so the other elements'
+	 * tables are refused without one for the first element.  Each table is indexed by the code
+	 * values of its own element when the elements differ in bit depth.
+	 *
+	 * The colour matrix multiplies the first three components of every pixel, normalized to
+	 * 0.0 - 1.0, after the lookup tables or the log to linear conversion, for instance to move
+	 * printing density primaries to Rec. 709 ones.  It holds 9 values, row by row, so the first
+	 * output component is matrix[0] * c0 + matrix[1] * c1 + matrix[2] * c2.  Integer buffers clamp
+	 * the results.  The buffer has to be kByte, kWord, kFloat or kHalf.
+	 *
+	 * The 3D lookup table transforms the first three components of every pixel after the colour
+	 * matrix, with tetrahedral interpolation.  It holds cubeSize^3
+	 * RGB triplets, red changing fastest, and takes and gives components normalized to 0.0 - 1.0.
+	 * The buffer has to be kByte, kWord, kFloat or kHalf.
+	 */
+	struct ReadOptions
+	{
+		long rowPitch;									//!< bytes from the first pixel of a line to the first pixel of the next line, may be negative, 0 for tightly packed lines
+		int pixelStride;								//!< bytes from the first component of a pixel to the first component of the next pixel, 0 for tightly packed pixels
+
+		bool alpha;										//!< add a constant component after the image's own components of every pixel
+		R32 alphaValue;									//!< value of the added component, normalized to 0.0 - 1.0
+
+		int channels[MAX_ELEMENTS];						//!< image component of each component of the buffer's pixels
+		int channelCount;								//!< number of listed channels, 0 for the image's components in their order
+
+		PixelFormat format;								//!< layout of the pixels
+
+		bool orient;									//!< return the pixels left to right, top to bottom whatever the image orientation
+
+		int proxy;										//!< 1 for full resolution, 2, 4 or 8 to keep every proxy-th line and pixel
+		bool proxyAverage;								//!< average each run of proxy pixels instead of keeping the first one
+
+		void *planes[MAX_ELEMENTS + 1];					//!< position of the first pixel of the block in the plane of each component, then of the alpha, 0 for interleaved pixels
+
+		bool logToLinear;								//!< convert printing density to linear light, kFloat and kHalf buffers only
+		R32 referenceBlack;								//!< 10-bit code value of reference black for the log to linear conversion
+		R32 referenceWhite;								//!< 10-bit code value of reference white for the log to linear conversion
+		R32 filmGamma;									//!< film gamma for the log to linear conversion, 0 to use the header's gamma (0.6 if undefined)
+
+		const void *lookup[MAX_ELEMENTS];				//!< lookup table of each image element indexed by code value, 0 for none
+
+		const R32 *matrix;								//!< 3x3 colour matrix, row major, 0 for none
+
+		const R32 *cube;								//!< 3D lookup table, 0 for none
+		int cubeSize;									//!< entries along each side of the 3D lookup table
+
+		/*!
+		 * \brief Constructor
+		 */
+		inline ReadOptions();
+	};
+
+
+	/*! \struct WriteOptions
+	 * \brief Conversions applied by the Writer to the image data it is given
+	 *
+	 * The defaults write the components as they are.
+	 *
+	 * The linear to log conversion is the inverse of the ReadOptions log to linear conversion,
+	 * it applies to kFloat and kHalf buffers and rounds every component to the nearest code value,
+	 * clamping it to the code range. Reference black has to be below reference white. All
+	 * elements share one encoding, WriteHeader() fails unless they have the bit depth and the low
+	 * and high data and quantity of the first element.
+	 *
+	 * The colour matrix works as the ReadOptions one and is applied before the linear to log
+	 * conversion, the buffer given to the Writer is left untouched.
+	 */
+	struct WriteOptions
+	{
+		bool linearToLog;								//!< encode linear light as printing density, kFloat and kHalf buffers only
+		R32 referenceBlack;								//!< 10-bit code value of reference black for the linear to log conversion
+		R32 referenceWhite;								//!< 10-bit code value of reference white for the linear to log conversion
+		R32 filmGamma;									//!< film gamma for the linear to log conversion, 0 to use the header's gamma (0.6 if undefined)
+
+		const R32 *matrix;								//!< 3x3 colour matrix, row major, 0 for none
+
+		/*!
+		 * \brief Constructor
+		 */
+		inline WriteOptions();
+	};
+
+
+	/*! \struct HeaderUpdate
+	 * \brief Fields UpdateHeaders() changes in the header of every file of a sequence
+	 *
+	 * The defaults keep every field as it is.  Strings are set unless 0, an empty string clearing
+	 * the field.
+	 *
+	 * The frame position and the film edge code follow the position of the file in the
+	 * sequence: the frame position of the file at index i is firstFramePosition + i *
+	 * framePositionStep, and its edge code is perfsPerFrame * i perfs past the given one, the
+	 * count going up by one every perfsPerCount perfs (64 for 35mm film).
+	 *
+	 * Only fields that leave the layout of the image data alone can be changed, so a header is
+	 * always rewritten over the old one without touching the rest of the file.
+	 */
+	struct HeaderUpdate
+	{
+		bool fileName;									//!< set the file name to the name of each file, without its directory
+
+		bool framePosition;								//!< set the frame position
+		U32 firstFramePosition;							//!< frame position of the first file
+		int framePositionStep;							//!< frame positions from one file to the next
+
+		bool filmEdgeCode;								//!< set the film edge code
+		U8 filmManufacturingIdCode;						//!< film edge code manufacturing ID code
+		U8 filmType;									//!< film edge code type
+		U32 prefix;										//!< film edge code prefix
+		U32 count;										//!< film edge code count of the first file
+		U8 perfsOffset;									//!< film edge code offset in perfs of the first file
+		int perfsPerFrame;								//!< perfs from one file to the next, 0 to give every file the same edge code
+		int perfsPerCount;								//!< perfs from one count to the next
+
+		const char *frameId;							//!< frame identification, 0 to keep it
+		const char *slateInfo;							//!< slate information, 0 to keep it
+		const char *format;								//!< format string, 0 to keep it
+		const char *labelText;							//!< label text, 0 to keep it
+		R32 frameRate;									//!< frame rate of the original, 0 to keep it
+
+		/*!
+		 * \brief Constructor
+		 */
+		inline HeaderUpdate();
+	};
+
+
 	// Current platform endian byte order
 	extern Endian systemByteOrder;
 
@@ -142,6 +380,80 @@ namespace cineon
 	 */
 	bool IdentifyFile(const void *data);
 
+	/*!
+	 * \brief Repack the image data of a file into another packing and byte order without decoding it
+	 *
+	 * The code values move straight from the words or cells of the source to those of the
+	 * destination, a run of components at a time, with the byte order changed on the way if
+	 * need be.  The header is written in the destination byte order with the new packing and
+	 * file size, its other fields and the user data are copied as they are.  The elements have
+	 * to share their bit depth, which may be anything up to 16 bits that both packings can hold.
+	 *
+	 * \param in source file
+	 * \param out destination file, written from its current position
+	 * \param packing packing of the destination
+	 * \param order byte order of the destination
+	 * \return success true/false
+	 */
+	bool Repack(InStream *in, OutStream *out, const Packing packing, const Endian order);
+
+	/*!
+	 * \brief Convert a 10-bit file to SMPTE DPX without decoding the image data
+	 *
+	 * 10-bit code values filled into 32-bit words, three to a word, are laid out the same way
+	 * in both formats, kLongWordLeft being DPX packing method A and kLongWordRight method B.
+	 * The DPX header is built from the Cineon one, a single pixel interleaved element holding
+	 * all the components, and the image data is copied as it is, the words only having their
+	 * bytes swapped when the byte order changes.  The user data and the end of image padding
+	 * are left out.
+	 *
+	 * \param in source file, all elements 10-bit of the same size and pixel interleaved
+	 * \param out destination file, written from its current position
+	 * \param order byte order of the destination
+	 * \return success true/false
+	 */
+	bool ConvertToDpx(InStream *in, OutStream *out, const Endian order);
+
+	/*!
+	 * \brief Convert a 10-bit file to SMPTE DPX without decoding the image data
+	 *
+	 * When the byte order is kept the image data is copied from one file to the other by the
+	 * kernel where the system allows it, without passing through the process.
+	 *
+	 * \param inFileName source file name
+	 * \param outFileName destination file name
+	 * \param order byte order of the destination
+	 * \return success true/false
+	 * \see ConvertToDpx(InStream *, OutStream *, const Endian)
+	 */
+	bool ConvertToDpx(const char *inFileName, const char *outFileName, const Endian order);
+
+	/*!
+	 * \brief Change fields of the header of a file in place
+	 *
+	 * The header is read, changed and written back over itself in the byte order of the file,
+	 * the image data is left untouched.
+	 *
+	 * \param fileName file to change
+	 * \param update fields to change
+	 * \param index position of the file in its sequence
+	 * \return success true/false
+	 */
+	bool UpdateHeader(const char *fileName, const HeaderUpdate &update, const int index = 0);
+
+	/*!
+	 * \brief Change fields of the headers of a sequence of files in place
+	 *
+	 * Files are updated concurrently, each with its own positional write of the header alone.
+	 *
+	 * \param fileNames files of the sequence in order
+	 * \param count number of files
+	 * \param update fields to change
+	 * \param status if not 0, receives the success of each file
+	 * \return number of files updated
+	 */
+	int UpdateHeaders(const char * const *fileNames, const int count, const HeaderUpdate &update, bool *status = 0);
+
 	/*!
 	 * \brief returns a char * of the default DPX file extension
 	 *
@@ -217,7 +529,8 @@ namespace cineon
 		 *
 		 * The DataSize allows the user to specific the buffer DataSize which can differ
 		 * from the image element.  It is possible, for example, to read an 8-bit per
-		 * component (3 components per pixel for RGB) into 16-bits.
+		 * component (3 components per pixel for RGB) into 16-bits.  kFloat and kHalf
+		 * buffers receive the components normalized to 0.0 - 1.0.
 		 *
 		 * \param data buffer
 		 * \param size size of the buffer component
@@ -238,6 +551,98 @@ namespace cineon
 		 */
 		bool ReadBlock(void *data, const DataSize size, Block &block);
 
+		/*!
+		 * \brief Read a rectangular image block into a buffer laid out as described by the options
+		 *
+		 * Each line of the block is decoded straight into its place in the buffer, so frames can
+		 * be read into a frame buffer or into part of a larger image without copying them afterwards.
+		 *
+		 * \param data buffer, the position of the first pixel of the block, ignored for planar buffers
+		 * \param size size of the buffer component
+		 * \param block image area to read
+		 * \param options layout of the buffer
+		 * \return success true/false
+		 */
+		bool ReadBlock(void *data, const DataSize size, Block &block, const ReadOptions &options);
+
+		/*!
+		 * \brief Read the image into a typed buffer
+		 *
+		 * \param span buffer of U8, U16, U32, U64, R32 or R16 components
+		 * \return success true/false
+		 * \see ReadBlock(const Span<BUF> &, Block &)
+		 */
+		template <typename BUF>
+		bool ReadImage(const Span<BUF> &span);
+
+		/*!
+		 * \brief Read a rectangular image block into a typed buffer
+		 *
+		 * The data size follows from the type of the components, kFloat for R32 and kHalf for
+		 * R16 ones, which are normalized to 0.0 - 1.0.  The conversion of the components to
+		 * that type is chosen when compiling, only the layout of the image data is looked at
+		 * when reading.  The block is stored tightly packed, the buffer has to hold all of its
+		 * components.
+		 *
+		 * \param span buffer of U8, U16, U32, U64, R32 or R16 components
+		 * \param block image area to read
+		 * \return success true/false
+		 */
+		template <typename BUF>
+		bool ReadBlock(const Span<BUF> &span, Block &block);
+
+		/*!
+		 * \brief Set the number of threads resampling the image data
+		 *
+		 * The image data is always read by the calling thread.  Without OpenMP support
+		 * the image data is always resampled by the calling thread.
+		 *
+		 * \param count thread count, 1 resamples serially (default), 0 or less uses all processors
+		 */
+		void SetThreadCount(const int count);
+
+		/*!
+		 * \brief Read the image resized to any size with a separable filter
+		 *
+		 * The image is read a band of lines at a time, only the source lines needed by the
+		 * band are decoded and kept, so the whole image never has to be held at its own size.
+		 * The lines are filtered across and then down in floating point, normalized to
+		 * 0.0 - 1.0, before they are stored as size.  The conversions of the options, such
+		 * as log to linear or the choice of channels, apply to the source lines, the layout
+		 * options have to be left as they are.  The source lines being read as kFloat, lookup
+		 * tables hold R32 entries and are only accepted when size is kFloat.
+		 *
+		 * \param data buffer of width by height tightly packed pixels
+		 * \param size size of the buffer component
+		 * \param width width of the resized image
+		 * \param height height of the resized image
+		 * \param filter resampling filter
+		 * \param options conversions of the source lines
+		 * \return success true/false
+		 */
+		bool ReadResampled(void *data, const DataSize size, const int width, const int height, const ResampleFilter filter,
+						   const ReadOptions &options = ReadOptions());
+
+		/*!
+		 * \brief Start reading the image a few lines at a time, from the top
+		 *
+		 * \param size size of the buffer component
+		 * \return success true/false
+		 */
+		bool BeginScanlines(const DataSize size = kWord);
+
+		/*!
+		 * \brief Read the next lines of the image started by Reader::BeginScanlines()
+		 *
+		 * The lines are decoded into the buffer one after another, the way Reader::ReadImage()
+		 * places them.
+		 *
+		 * \param data buffer for count lines
+		 * \param count number of lines to read
+		 * \return number of lines read, less than count at the end of the image, -1 on error
+		 */
+		int ReadScanlines(void *data, const int count);
+
 		/*!
 		 * \brief Read the user data into a buffer.
 		 *
@@ -254,6 +659,18 @@ namespace cineon
 
 		Codec *codec;
 		ElementReadStream *rio;
+
+		// scanline reading state
+		DataSize scanSize;
+		int scanLine;
+
+		int threads;
+
+		bool ReadOriented(void *data, const DataSize size, const Block &block, const ReadOptions &options);
+
+		// whole lines of an image stored as the buffer holds them are read straight into it
+		bool StoredAsBuffer(const DataSize size, const Block &block) const;
+		bool ReadStored(void *data, const DataSize size, const Block &block);
 	};
 
 
@@ -361,6 +778,27 @@ namespace cineon
 		 */
 		void SetOutStream(OutStream *stream);
 
+		/*!
+		 * \brief Set the number of threads converting and packing the image data
+		 *
+		 * With more than one thread, Writer::WriteElement() converts and packs bands of
+		 * lines in parallel and writes the bands out in order.  Without OpenMP support
+		 * the image data is always written by the calling thread.
+		 *
+		 * \param count thread count, 1 writes serially (default), 0 or less uses all processors
+		 */
+		void SetThreadCount(const int count);
+
+		/*!
+		 * \brief Set the conversions applied to the image data
+		 *
+		 * The options take effect with the next Writer::WriteHeader(), which prepares the
+		 * conversions for the bit depth and the reference values in the header.
+		 *
+		 * \param options conversions
+		 */
+		void SetWriteOptions(const WriteOptions &options);
+
 		/*!
 		 * \brief Set the size of the user data area
 		 *
@@ -394,6 +832,51 @@ namespace cineon
 		bool WriteElement(const int element, void *data, const DataSize size);
 		bool WriteElement(const int element, void *data, const long count);
 
+		/*!
+		 * \brief Write a band of lines of the element to their place in the dpx file
+		 *
+		 * The position of every line in the file is known from the header, so the bands
+		 * can be written in any order and by several threads at once, provided that each
+		 * band is written once.  The header has to be written before the first band and
+		 * Writer::Finish() called after the last one.
+		 *
+		 * \param element element number (0-7)
+		 * \param data buffer holding the lines of the band
+		 * \param size size of the buffer component
+		 * \param firstLine first line of the band
+		 * \param lineCount number of lines in the band
+		 * \return success true/false
+		 */
+		bool WriteBand(const int element, void *data, const DataSize size, const int firstLine, const int lineCount);
+
+		/*!
+		 * \brief Start writing the element a few lines at a time
+		 *
+		 * The lines passed to Writer::WriteScanlines() are packed and written as they
+		 * arrive, so the whole image never has to be held in memory.
+		 *
+		 * \param element element number (0-7)
+		 * \param size size of the buffer component
+		 * \return success true/false
+		 */
+		bool BeginScanlines(const int element, const DataSize size);
+
+		/*!
+		 * \brief Write the next lines of the element started by Writer::BeginScanlines()
+		 *
+		 * \param data buffer holding the lines
+		 * \param count number of lines in the buffer
+		 * \return success true/false
+		 */
+		bool WriteScanlines(void *data, const int count);
+
+		/*!
+		 * \brief Finish writing the element started by Writer::BeginScanlines()
+		 *
+		 * \return success true/false, false if not all of the lines have been written
+		 */
+		bool EndScanlines();
+
 		/**
 		 * \brief Finish up writing image
 		 *
@@ -405,8 +888,22 @@ namespace cineon
 	protected:
 		long fileLoc;
 		OutStream *fd;
+		int threads;
+
+		// conversions
+		WriteOptions options;
+		LogEncoding *encoding;							//!< linear light to printing density, 0 without linear to log
+
+		// scanline writing state
+		int scanElement;
+		DataSize scanSize;
+		U32 scanLine;
+		unsigned char *scanBuffer;
+		int scanBufferSize;
+		char *scanBlank;
 
 		bool WriteThrough(void *, const U32, const U32, const int, const int, const U32, const U32, char *);
+		bool PrepareEncoding();
 
 	};
 
@@ -470,6 +967,38 @@ inline void cineon::Block::Check()
 }
 
 
+inline cineon::ReadOptions::ReadOptions() : rowPitch(0), pixelStride(0), alpha(false), alphaValue(1.0f), channelCount(0),
+	format(kComponents), orient(false), proxy(1), proxyAverage(false),
+	logToLinear(false), referenceBlack(95.0f), referenceWhite(685.0f), filmGamma(0.0f), matrix(0), cube(0), cubeSize(0)
+{
+	for (int i = 0; i < MAX_ELEMENTS; i++)
+	{
+		this->lookup[i] = 0;
+		this->channels[i] = i;
+	}
+	for (int i = 0; i <= MAX_ELEMENTS; i++)
+		this->planes[i] = 0;
+}
+
+
+inline cineon::WriteOptions::WriteOptions() : linearToLog(false), referenceBlack(95.0f), referenceWhite(685.0f), filmGamma(0.0f), matrix(0)
+{
+}
+
+
+inline cineon::HeaderUpdate::HeaderUpdate() : fileName(false), framePosition(false), firstFramePosition(0), framePositionStep(1),
+	filmEdgeCode(false), filmManufacturingIdCode(0), filmType(0), prefix(0), count(0), perfsOffset(0), perfsPerFrame(0), perfsPerCount(64),
+	frameId(0), slateInfo(0), format(0), labelText(0), frameRate(0.0f)
+{
+}
+
+
+template <typename T>
+inline cineon::Span<T>::Span(T *d, const size_t c) : data(d), count(c)
+{
+}
+
+
 inline bool cineon::Block::Inside(const int x, const int y) const
 {
 	if (x >= this->x1 && x <= this->x2 && y >= this->y1 && y <= this->y2)
@@ -104,6 +104,8 @@ void cineon::GenericHeader::Reset()
 	this->imageOrientation = kUndefinedOrientation;
 	this->numberOfElements = 0xff;
 	this->unused1[0] = this->unused1[1] = 0xff;
+	for (int i = 0; i < MAX_ELEMENTS; i++)
+		this->chan[i] = ImageElement();
 	EmptyVector(this->whitePoint);
 	EmptyVector(this->redPrimary);
 	EmptyVector(this->greenPrimary);
@@ -145,6 +147,7 @@ void cineon::IndustryHeader::Reset()
 	this->filmManufacturingIdCode = 0xFF;
 	this->filmType = 0xFF;
 	this->perfsOffset = 0xFF;
+	this->unused1 = 0xFF;
 	this->prefix = 0xFFFFFFFF;
 	this->count = 0xFFFFFFFF;
 	EmptyString(this->format);
@@ -158,6 +161,11 @@ void cineon::IndustryHeader::Reset()
 
 cineon::ImageElement::ImageElement()
 {
+	this->designator[0] = 0;
+	this->designator[1] = kUndefinedDescriptor;
+	this->unused1 = 0xff;
+	this->pixelsPerLine = 0xffffffff;
+	this->linesPerElement = 0xffffffff;
 	this->lowData = 0xffffffff;
 	this->lowQuantity = 0xffffffff;
 	this->highData = 0xffffffff;
@@ -220,6 +228,40 @@ bool cineon::Header::Write(OutStream *io)
 }
 
 
+// the fields are held in the machine's byte order once read, the header is written from a copy
+// holding them and the magic number in the byte order asked for
+
+bool cineon::Header::Write(OutStream *io, const bool swap) const
+{
+	Header header(*this);
+
+	header.magicNumber = MAGIC_COOKIE;
+	if (swap)
+	{
+		header.SwapFieldBytes();
+		SwapBytes(header.magicNumber);
+	}
+
+	return header.Write(io);
+}
+
+
+bool cineon::Header::Rewrite(OutStream *io, const bool swap) const
+{
+	Header header(*this);
+
+	header.magicNumber = MAGIC_COOKIE;
+	if (swap)
+	{
+		header.SwapFieldBytes();
+		SwapBytes(header.magicNumber);
+	}
+
+	const size_t r = sizeof(GenericHeader) + sizeof(IndustryHeader);
+	return (io->WriteAt(&header.magicNumber, r, 0) == r);
+}
+
+
 bool cineon::Header::WriteOffsetData(OutStream *io)
 {
 	// calculate the number of elements
@@ -234,17 +276,17 @@ bool cineon::Header::WriteOffsetData(OutStream *io)
 
 
 	// write the file size
-	const long FIELD4 = 16;			// offset to total image file size in header
-	if (io->Seek(FIELD4, OutStream::kStart) == false)
+	const long FIELD6 = 20;			// offset to total image file size in header
+	if (io->Seek(FIELD6, OutStream::kStart) == false)
 		return false;
 	if (io->Write(&this->fileSize, sizeof(U32)) == false)
 		return false;
 
 	// write the number of elements
-	const long FIELD19 = 770;		// offset to number of image elements in header
-	if (io->Seek(FIELD19, OutStream::kStart) == false)
+	const long FIELD12 = 193;		// offset to number of image elements in header
+	if (io->Seek(FIELD12, OutStream::kStart) == false)
 		return false;
-	if (io->Write(&this->numberOfElements, sizeof(U16)) == false)
+	if (io->Write(&this->numberOfElements, sizeof(U8)) == false)
 		return false;
 
 	// write the image offsets
@@ -306,58 +348,61 @@ bool cineon::Header::Validate()
 
 	// determine if bytes needs to be swapped around
 	if (this->DetermineByteSwap(this->magicNumber))
-	{
-		// File information
-		SwapBytes(this->imageOffset);
-		SwapBytes(this->genericSize);
-		SwapBytes(this->industrySize);
-		SwapBytes(this->userSize);
-		SwapBytes(this->fileSize);
-
-		// Image information
-		for (int i = 0; i < MAX_ELEMENTS; i++)
-		{
-			SwapBytes(this->chan[i].pixelsPerLine);
-			SwapBytes(this->chan[i].linesPerElement);
-			SwapBytes(this->chan[i].lowData);
-			SwapBytes(this->chan[i].lowQuantity);
-			SwapBytes(this->chan[i].highData);
-			SwapBytes(this->chan[i].highQuantity);
-			SwapBytes(this->chan[i].bitDepth);
-		}
-		SwapBytes(this->whitePoint[0]);
-		SwapBytes(this->whitePoint[1]);
-		SwapBytes(this->redPrimary[0]);
-		SwapBytes(this->redPrimary[1]);
-		SwapBytes(this->greenPrimary[0]);
-		SwapBytes(this->greenPrimary[1]);
-		SwapBytes(this->bluePrimary[0]);
-		SwapBytes(this->bluePrimary[1]);
-		SwapBytes(this->endOfLinePadding);
-		SwapBytes(this->endOfImagePadding);
-
-
-		// Image Origination information
-		SwapBytes(this->xOffset);
-		SwapBytes(this->yOffset);
-		SwapBytes(this->xDevicePitch);
-		SwapBytes(this->yDevicePitch);
-		SwapBytes(this->gamma);
-
-
-		// Motion Picture Industry Specific
-		SwapBytes(this->prefix);
-		SwapBytes(this->count);
-		SwapBytes(this->framePosition);
-		SwapBytes(this->frameRate);
-
-	}
+		this->SwapFieldBytes();
 
 	return true;
 }
 
 
 
+void cineon::Header::SwapFieldBytes()
+{
+	// File information
+	SwapBytes(this->imageOffset);
+	SwapBytes(this->genericSize);
+	SwapBytes(this->industrySize);
+	SwapBytes(this->userSize);
+	SwapBytes(this->fileSize);
+
+	// Image information
+	for (int i = 0; i < MAX_ELEMENTS; i++)
+	{
+		SwapBytes(this->chan[i].pixelsPerLine);
+		SwapBytes(this->chan[i].linesPerElement);
+		SwapBytes(this->chan[i].lowData);
+		SwapBytes(this->chan[i].lowQuantity);
+		SwapBytes(this->chan[i].highData);
+		SwapBytes(this->chan[i].highQuantity);
+		SwapBytes(this->chan[i].bitDepth);
+	}
+	SwapBytes(this->whitePoint[0]);
+	SwapBytes(this->whitePoint[1]);
+	SwapBytes(this->redPrimary[0]);
+	SwapBytes(this->redPrimary[1]);
+	SwapBytes(this->greenPrimary[0]);
+	SwapBytes(this->greenPrimary[1]);
+	SwapBytes(this->bluePrimary[0]);
+	SwapBytes(this->bluePrimary[1]);
+	SwapBytes(this->endOfLinePadding);
+	SwapBytes(this->endOfImagePadding);
+
+
+	// Image Origination information
+	SwapBytes(this->xOffset);
+	SwapBytes(this->yOffset);
+	SwapBytes(this->xDevicePitch);
+	SwapBytes(this->yDevicePitch);
+	SwapBytes(this->gamma);
+
+
+	// Motion Picture Industry Specific
+	SwapBytes(this->prefix);
+	SwapBytes(this->count);
+	SwapBytes(this->framePosition);
+	SwapBytes(this->frameRate);
+}
+
+
 void cineon::Header::Reset()
 {
 	GenericHeader::Reset();
@@ -407,6 +452,17 @@ void cineon::Header::CalculateOffsets()
 }
 
 
+// the image elements of a Cineon file are pixel interleaved, so a pixel of any element
+// carries one component of every image element
+int cineon::GenericHeader::ImageElementComponentCount(const int element) const
+{
+	if (element < 0 || element >= MAX_ELEMENTS)
+		return 0;
+
+	return this->ImageElementCount();
+}
+
+
 cineon::DataSize cineon::GenericHeader::ComponentDataSize(const int element) const
 {
 	if (element < 0 || element >= MAX_ELEMENTS)
@@ -484,12 +540,79 @@ int cineon::GenericHeader::DataSizeByteCount(const DataSize ds)
 	case kLongLong:
 		ret = sizeof(U64);
 		break;
+	case kFloat:
+		ret = sizeof(R32);
+		break;
+	case kHalf:
+		ret = sizeof(R16);
+		break;
 	}
 
 	return ret;
 }
 
 
+// components are stored in cells of a byte, a word or a longword unless they are packed, cells
+// of a packing value outside the enumeration are taken as the components' own data type
+int cineon::GenericHeader::PackingCellBits(const int bitDepth, const Packing packing)
+{
+	int cell;
+
+	switch (packing & ~kPackAsManyAsPossible)
+	{
+	case kByteLeft:
+	case kByteRight:
+		cell = 8;
+		break;
+	case kWordLeft:
+	case kWordRight:
+		cell = 16;
+		break;
+	case kLongWordLeft:
+	case kLongWordRight:
+		cell = 32;
+		break;
+	default:
+		return 0;
+	}
+
+	// components that fill whole cells are read and written as their own data type
+	if (bitDepth < 1 || bitDepth > 16 || bitDepth % cell == 0)
+		return 0;
+
+	return (bitDepth + cell - 1) / cell * cell;
+}
+
+
+int cineon::GenericHeader::PackingCellComponents(const int bitDepth, const Packing packing)
+{
+	const int bits = PackingCellBits(bitDepth, packing);
+	if (bits == 0)
+		return 0;
+
+	if ((packing & kPackAsManyAsPossible) || (bitDepth == 10 && bits == 32))
+		return bits / bitDepth;
+
+	return 1;
+}
+
+
+long cineon::GenericHeader::PackedLineByteCount(const int bitDepth, const Packing packing, const long count)
+{
+	const int bits = PackingCellBits(bitDepth, packing);
+	if (bits)
+	{
+		const int components = PackingCellComponents(bitDepth, packing);
+		return (count + components - 1) / components * (bits / 8);
+	}
+
+	if (packing == kPacked && bitDepth != 8 && bitDepth < 16)
+		return (count * bitDepth + 31) / 32 * long(sizeof(U32));
+
+	return count * (bitDepth <= 8 ? 1 : (bitDepth <= 16 ? 2 : (bitDepth <= 32 ? 4 : 8)));
+}
+
+
 void cineon::IndustryHeader::FilmEdgeCode(char *edge) const
 {
 	if (this->filmManufacturingIdCode == 0xff
@@ -624,4 +747,59 @@ cineon::U32 cineon::Header::Width() const
 }
 
 
+// StoredHeight()
+// number of lines the image data is stored as, the lines run along the height of the image
+// unless it is oriented top to bottom or bottom to top
+
+cineon::U32 cineon::Header::StoredHeight() const
+{
+	U32 h = 0;
+
+	for (int i = 0; i < this->NumberOfElements(); i++) {
+		if (this->LinesPerElement(i) > h)
+			h = this->LinesPerElement(i);
+	}
+
+	return h;
+}
+
+
+// StoredWidth()
+// number of pixels in each line the image data is stored as
+
+cineon::U32 cineon::Header::StoredWidth() const
+{
+	U32 w = 0;
+
+	for (int i = 0; i < this->NumberOfElements(); i++) {
+		if (this->PixelsPerLine(i) > w)
+			w = this->PixelsPerLine(i);
+	}
+
+	return w;
+}
+
+
+bool cineon::Header::ConsistentBitDepth() const
+{
+	for (int i = 1; i < this->NumberOfElements(); i++) {
+		if (this->BitDepth(i) != this->BitDepth(0))
+			return false;
+	}
+
+	return true;
+}
+
+
+bool cineon::Header::ConsistentSize() const
+{
+	for (int i = 1; i < this->NumberOfElements(); i++) {
+		if (this->PixelsPerLine(i) != this->PixelsPerLine(0) || this->LinesPerElement(i) != this->LinesPerElement(0))
+			return false;
+	}
+
+	return true;
+}
+
+
 
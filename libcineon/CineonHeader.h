@@ -124,6 +124,15 @@ namespace cineon
 	 */
 	typedef double			R64;
 
+	/*!
+	 * \struct R16
+	 * \brief 16 bit (half) floating point number, stored as its IEEE 754 bits
+	 */
+	struct R16
+	{
+		U16					bits;						//!< sign, 5 bit exponent and 10 bit mantissa
+	};
+
 	/*!
 	 * \typedef char ASCII
 	 * \brief ASCII character
@@ -140,7 +149,9 @@ namespace cineon
 		kByte,											//!< 8-bit size component
 		kWord,											//!<
 		kInt,											//!<
-		kLongLong										//!< 64-bit integer
+		kLongLong,										//!< 64-bit integer
+		kFloat,											//!< 32-bit floating point, normalized to 0.0 - 1.0
+		kHalf											//!< 16-bit floating point, normalized to 0.0 - 1.0
 	};
 
 
@@ -907,6 +918,33 @@ namespace cineon
 		 */
 		static int DataSizeByteCount(const DataSize ds);
 
+		/*!
+		 * \brief Bits of the cell a run of components is stored in with the given packing, components wider
+		 * than a cell of the packing take as many cells as they need, the first one most significant
+		 * \param bitDepth component bit depth
+		 * \param packing packing method
+		 * \return bit count, 0 when the components are packed one after the other or fill their cells
+		 */
+		static int PackingCellBits(const int bitDepth, const Packing packing);
+
+		/*!
+		 * \brief Number of components in each cell with the given packing, one unless they are packed as many
+		 * as possible per cell, apart from 10-bit components that always go three to a longword
+		 * \param bitDepth component bit depth
+		 * \param packing packing method
+		 * \return component count, 0 when the components are not stored in cells
+		 */
+		static int PackingCellComponents(const int bitDepth, const Packing packing);
+
+		/*!
+		 * \brief Byte count of a line of components of the same bit depth, each line starting with a new cell
+		 * \param bitDepth component bit depth
+		 * \param packing packing method
+		 * \param count number of components in the line
+		 * \return byte count
+		 */
+		static long PackedLineByteCount(const int bitDepth, const Packing packing, const long count);
+
 	};
 
 
@@ -1057,6 +1095,26 @@ namespace cineon
 		 */
 		bool				Write(OutStream *);
 
+		/*!
+		 * \brief Write the header to the Output Stream in the machine's byte order or the opposite one
+		 * \param io stream to write to
+		 * \param swap write in the byte order opposite of the machine's
+		 * \return success true/false
+		 */
+		bool				Write(OutStream *io, const bool swap) const;
+
+		/*!
+		 * \brief Write the header over the one at the start of the file with a positional write
+		 *
+		 * The file pointer is left where it is and nothing past the header is touched, so the
+		 * header of a file can be changed in place.
+		 *
+		 * \param io stream to write to
+		 * \param swap write in the byte order opposite of the machine's
+		 * \return success true/false
+		 */
+		bool				Rewrite(OutStream *io, const bool swap) const;
+
 		// write the offset within the header
 		bool				WriteOffsetData(OutStream *);
 
@@ -1110,9 +1168,36 @@ namespace cineon
 		 */
 		U32					Width() const;
 
+		/*!
+		 * \brief Number of lines stored in the file (maximum of all elements' lines), whatever the orientation
+		 * \return height
+		 */
+		U32					StoredHeight() const;
+
+		/*!
+		 * \brief Number of pixels in each line stored in the file (maximum of all elements' widths), whatever the orientation
+		 * \return width
+		 */
+		U32					StoredWidth() const;
+
+		/*!
+		 * \brief Whether all the image elements have the bit depth of the first one
+		 * \return consistent true/false
+		 */
+		bool				ConsistentBitDepth() const;
+
+		/*!
+		 * \brief Whether all the image elements have the pixels per line and lines of the first one
+		 * \return consistent true/false
+		 */
+		bool				ConsistentSize() const;
+
 
 	protected:
 		bool DetermineByteSwap(const U32 magic) const;
+
+		// swap the bytes of every numeric field but the magic number
+		void SwapFieldBytes();
 	};
 
 
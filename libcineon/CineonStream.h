@@ -165,6 +165,13 @@ class OutStream
 	 */
 	virtual bool Open(const char *fn);
 
+	/*!
+	 * \brief Open an existing file to write over parts of it, keeping the rest
+	 * \param fn File name
+	 * \return success true/false
+	 */
+	virtual bool OpenForUpdate(const char *fn);
+
 	/*!
 	 * \brief Close file
 	 */
@@ -178,6 +185,18 @@ class OutStream
 	 */
 	virtual size_t Write(void * buf, const size_t size);
 
+	/*!
+	 * \brief Write data to a position in the file without moving the file pointer
+	 *
+	 * Positional writes of different threads to distinct areas of the file may overlap in time.
+	 *
+	 * \param buf data buffer
+	 * \param size bytes to write
+	 * \param offset position in the file, from the beginning of the file
+	 * \return number of bytes written
+	 */
+	virtual size_t WriteAt(void * buf, const size_t size, const long offset);
+
 	/*!
 	 * \brief Seek to a position in the file
 	 * \param offset offset from originating position
@@ -36,11 +36,12 @@
 #include "Codec.h"
 #include "ElementReadStream.h"
 #include "ReaderInternal.h"
+#include "ColorMatrix.h"
 
 
 
 
-cineon::Codec::Codec() : scanline(0)
+cineon::Codec::Codec() : scanline(0), line(0), lineSize(0), linear(0), linearHalf(0), linearBits(0)
 {
 }
 
@@ -49,6 +50,12 @@ cineon::Codec::~Codec()
 {
 	if (this->scanline)
 		delete [] scanline;
+	if (this->line)
+		delete [] line;
+	if (this->linear)
+		delete [] linear;
+	if (this->linearHalf)
+		delete [] linearHalf;
 }
 
 
@@ -59,31 +66,531 @@ void cineon::Codec::Reset()
 		delete [] scanline;
 		this->scanline = 0;
 	}
+	if (this->line)
+	{
+		delete [] line;
+		this->line = 0;
+		this->lineSize = 0;
+	}
+	if (this->linear)
+	{
+		delete [] linear;
+		this->linear = 0;
+	}
+	if (this->linearHalf)
+	{
+		delete [] linearHalf;
+		this->linearHalf = 0;
+	}
+	this->linearBits = 0;
 }
 
 
-bool cineon::Codec::Read(const Header &dpxHeader, ElementReadStream *fd, const Block &block, void *data, const DataSize size)
+void cineon::Codec::AllocateScanline(const Header &dpxHeader)
 {
-	// scanline buffer
-	if (this->scanline == 0)
+	// bytes of a pixel, each element's component taking the bytes of its own bit depth,
+	// which is never less than it takes packed
+	int pixelBytes = 0;
+	for (int i = 0; i < dpxHeader.NumberOfElements(); i++)
 	{
-		// FIXME: make this flexible enough to change per-channel differences!
+		const int bitDepth = dpxHeader.BitDepth(i);
+		pixelBytes += (bitDepth <= 8 ? 1 : (bitDepth <= 16 ? 2 : (bitDepth <= 32 ? 4 : 8)));
+	}
+
+	// size of the scanline buffer is image width * bytes per pixel, and a word for a block
+	// starting in the middle of one
+	int slsize = ((dpxHeader.StoredWidth() * pixelBytes) / sizeof(U32)) + 2;
+
+	// cells may take more room than the components
+	if (dpxHeader.ConsistentBitDepth())
+	{
+		const long cellSize = Header::PackedLineByteCount(dpxHeader.BitDepth(0), dpxHeader.ImagePacking(),
+														  long(dpxHeader.StoredWidth()) * dpxHeader.NumberOfElements());
+		slsize = std::max(slsize, int(cellSize / sizeof(U32)) + 2);
+	}
 
-		// get the number of components for this element descriptor
-		const int numberOfComponents = dpxHeader.NumberOfElements();
+	this->scanline = new U32[slsize];
+}
+
+
+cineon::U8 *cineon::Codec::LineBuffer(const size_t size)
+{
+	if (size > this->lineSize)
+	{
+		if (this->line)
+			delete [] line;
+		this->line = new U8[size];
+		this->lineSize = size;
+	}
+	return this->line;
+}
+
+
+const void *cineon::Codec::LinearTable(const Header &dpxHeader, const DataSize size, const ReadOptions &options)
+{
+	// the conversion is set up from the first element, the others need its bit depth
+	const int bitDepth = dpxHeader.BitDepth(0);
+	if (bitDepth > 16 || dpxHeader.ConsistentBitDepth() == false)
+		return 0;
+
+	PrintingDensity conversion;
+	if (conversion.Set(dpxHeader, 0, options.referenceBlack, options.referenceWhite, options.filmGamma) == false)
+		return 0;
+
+	const int maxCode = (1 << bitDepth) - 1;
+
+	// build the table unless the one from the last read fits
+	if (this->linear == 0 || this->linearBits != bitDepth || !(this->linearConversion == conversion))
+	{
+		if (this->linear)
+			delete [] linear;
+		if (this->linearHalf)
+			delete [] linearHalf;
+		this->linearHalf = 0;
+
+		this->linear = new R32[maxCode + 1];
+		this->linearBits = bitDepth;
+		this->linearConversion = conversion;
+
+		for (int i = 0; i <= maxCode; i++)
+			this->linear[i] = R32(conversion.Linear(i * 1023.0 / maxCode));
+	}
+
+	if (size == kFloat)
+		return this->linear;
+
+	if (size == kHalf)
+	{
+		if (this->linearHalf == 0)
+		{
+			this->linearHalf = new R16[maxCode + 1];
+			for (int i = 0; i <= maxCode; i++)
+				this->linearHalf[i].bits = FloatToHalf(this->linear[i]);
+		}
+		return this->linearHalf;
+	}
 
-		// bit depth of the image element
-		const int bitDepth = dpxHeader.BitDepth(0);
+	return 0;
+}
+
+
+// read a line through a converter, keeping either all of the components or only the ones
+// positions places in the pixels of count components
+template <typename BUF, cineon::DataSize BUFTYPE, typename CONV>
+static bool ReadLineConvert(const cineon::Header &dpxHeader, cineon::U32 *scanline, cineon::ElementReadStream *fd, const cineon::Block &block,
+							void *data, const CONV &conv, const int *positions, const int count)
+{
+	if (positions == 0)
+		return cineon::ReadImageBlock<cineon::ElementReadStream, BUF, BUFTYPE>(dpxHeader, scanline, fd, block, reinterpret_cast<BUF *>(data), conv);
+
+	return cineon::ReadImageBlock<cineon::ElementReadStream, BUF, BUFTYPE>(dpxHeader, scanline, fd, block, reinterpret_cast<BUF *>(data),
+			cineon::SwizzleConvert<BUF, CONV>(conv, reinterpret_cast<BUF *>(data), dpxHeader.NumberOfElements(), count, positions));
+}
+
+
+// read a line through a table shared by all elements or through a table per element
+template <typename BUF, cineon::DataSize BUFTYPE>
+static bool ReadLineTables(const cineon::Header &dpxHeader, cineon::U32 *scanline, cineon::ElementReadStream *fd, const cineon::Block &block,
+						   void *data, const void * const *tables, const int tableCount, const int *positions, const int count)
+{
+	// tables are indexed by code value, the converters follow the bit depth of each element
+	const int bitDepth = dpxHeader.BitDepth(0);
+
+	if (tableCount == 1)
+		return ReadLineConvert<BUF, BUFTYPE>(dpxHeader, scanline, fd, block, data,
+				cineon::LookupConvert<BUF>(reinterpret_cast<const BUF *>(tables[0]), bitDepth), positions, count);
+
+	return ReadLineConvert<BUF, BUFTYPE>(dpxHeader, scanline, fd, block, data,
+			cineon::ChannelLookupConvert<BUF>(reinterpret_cast<const BUF * const *>(tables), tableCount, bitDepth), positions, count);
+}
+
+
+// read the elements of a channel interleaved image straight into the planes of the buffer
+template <typename BUF, typename CONV>
+static bool ReadPlanesConvert(const cineon::Header &dpxHeader, cineon::U32 *scanline, cineon::ElementReadStream *fd, const cineon::Block &block,
+							  cineon::U8 * const *targets, const int stride, const long pitch, const CONV &conv)
+{
+	BUF *planes[MAX_ELEMENTS];
+	for (int i = 0; i < dpxHeader.NumberOfElements(); i++)
+		planes[i] = reinterpret_cast<BUF *>(targets[i]);
+
+	return cineon::ReadElementsInterleaved<cineon::ElementReadStream, BUF, CONV>(dpxHeader, scanline, fd, block, planes, stride, pitch, conv);
+}
+
+
+template <typename BUF>
+static bool ReadPlanesTables(const cineon::Header &dpxHeader, cineon::U32 *scanline, cineon::ElementReadStream *fd, const cineon::Block &block,
+							 cineon::U8 * const *targets, const int stride, const long pitch, const void * const *tables, const int tableCount)
+{
+	const int bitDepth = dpxHeader.BitDepth(0);
+
+	if (tableCount == 0)
+		return ReadPlanesConvert<BUF>(dpxHeader, scanline, fd, block, targets, stride, pitch, cineon::ComponentConvert(bitDepth));
+	else if (tableCount == 1)
+		return ReadPlanesConvert<BUF>(dpxHeader, scanline, fd, block, targets, stride, pitch,
+				cineon::LookupConvert<BUF>(reinterpret_cast<const BUF *>(tables[0]), bitDepth));
+
+	return ReadPlanesConvert<BUF>(dpxHeader, scanline, fd, block, targets, stride, pitch,
+			cineon::ChannelLookupConvert<BUF>(reinterpret_cast<const BUF * const *>(tables), tableCount, bitDepth));
+}
+
+
+bool cineon::Codec::ReadPlanes(const Header &dpxHeader, ElementReadStream *fd, const Block &block, const DataSize size,
+							   U8 * const *targets, const int stride, const long pitch, const void * const *tables, const int tableCount)
+{
+	if (size == cineon::kByte)
+		return ReadPlanesTables<U8>(dpxHeader, this->scanline, fd, block, targets, stride, pitch, tables, tableCount);
+	else if (size == cineon::kWord)
+		return ReadPlanesTables<U16>(dpxHeader, this->scanline, fd, block, targets, stride, pitch, tables, tableCount);
+	else if (size == cineon::kFloat)
+		return ReadPlanesTables<R32>(dpxHeader, this->scanline, fd, block, targets, stride, pitch, tables, tableCount);
+	else if (size == cineon::kHalf)
+		return ReadPlanesTables<R16>(dpxHeader, this->scanline, fd, block, targets, stride, pitch, tables, tableCount);
+
+	// lookup tables only come in the types above
+	if (tableCount)
+		return false;
+
+	if (size == cineon::kInt)
+		return ReadPlanesConvert<U32>(dpxHeader, this->scanline, fd, block, targets, stride, pitch, ComponentConvert(dpxHeader.BitDepth(0)));
+	else if (size == cineon::kLongLong)
+		return ReadPlanesConvert<U64>(dpxHeader, this->scanline, fd, block, targets, stride, pitch, ComponentConvert(dpxHeader.BitDepth(0)));
+
+	return false;
+}
+
+
+bool cineon::Codec::ReadLine(const Header &dpxHeader, ElementReadStream *fd, const Block &block, void *data,
+							 const DataSize size, const void * const *tables, const int tableCount, const int *positions, const int count)
+{
+	if (tableCount == 0)
+	{
+		if (positions == 0)
+			return ReadImageBlock<ElementReadStream>(dpxHeader, this->scanline, fd, block, data, size);
 
-		// size of the scanline buffer is image width * number of components * bytes per component
-		int slsize = ((numberOfComponents * dpxHeader.Width() *
-					  (bitDepth / 8 + (bitDepth % 8 ? 1 : 0))) / sizeof(U32))+1;
+		const ComponentConvert conv(dpxHeader.BitDepth(0));
+		if (size == cineon::kByte)
+			return ReadLineConvert<U8, cineon::kByte>(dpxHeader, this->scanline, fd, block, data, conv, positions, count);
+		else if (size == cineon::kWord)
+			return ReadLineConvert<U16, cineon::kWord>(dpxHeader, this->scanline, fd, block, data, conv, positions, count);
+		else if (size == cineon::kInt)
+			return ReadLineConvert<U32, cineon::kInt>(dpxHeader, this->scanline, fd, block, data, conv, positions, count);
+		else if (size == cineon::kLongLong)
+			return ReadLineConvert<U64, cineon::kLongLong>(dpxHeader, this->scanline, fd, block, data, conv, positions, count);
+		else if (size == cineon::kFloat)
+			return ReadLineConvert<R32, cineon::kFloat>(dpxHeader, this->scanline, fd, block, data, conv, positions, count);
+		else if (size == cineon::kHalf)
+			return ReadLineConvert<R16, cineon::kHalf>(dpxHeader, this->scanline, fd, block, data, conv, positions, count);
 
-		this->scanline = new U32[slsize];
+		return false;
 	}
 
+	for (int i = 0; i < dpxHeader.NumberOfElements(); i++)
+		if (dpxHeader.BitDepth(i) > 16)
+			return false;
+
+	if (size == cineon::kByte)
+		return ReadLineTables<U8, cineon::kByte>(dpxHeader, this->scanline, fd, block, data, tables, tableCount, positions, count);
+	else if (size == cineon::kWord)
+		return ReadLineTables<U16, cineon::kWord>(dpxHeader, this->scanline, fd, block, data, tables, tableCount, positions, count);
+	else if (size == cineon::kFloat)
+		return ReadLineTables<R32, cineon::kFloat>(dpxHeader, this->scanline, fd, block, data, tables, tableCount, positions, count);
+	else if (size == cineon::kHalf)
+		return ReadLineTables<R16, cineon::kHalf>(dpxHeader, this->scanline, fd, block, data, tables, tableCount, positions, count);
+
+	return false;
+}
+
+
+bool cineon::Codec::Read(const Header &dpxHeader, ElementReadStream *fd, const Block &block, void *data, const DataSize size)
+{
+	// scanline buffer
+	if (this->scanline == 0)
+		this->AllocateScanline(dpxHeader);
 
 	// read the image block
 	return ReadImageBlock<ElementReadStream>(dpxHeader, this->scanline, fd, block, data, size);
 }
 
+
+template <typename BUF>
+bool cineon::Codec::Read(const Header &dpxHeader, ElementReadStream *fd, const Block &block, BUF *data)
+{
+	// scanline buffer
+	if (this->scanline == 0)
+		this->AllocateScanline(dpxHeader);
+
+	// read the image block
+	const ComponentConvert conv(dpxHeader.BitDepth(0));
+	return ReadImageBlock<ElementReadStream, BUF, BufferType<BUF>::size>(dpxHeader, this->scanline, fd, block, data, conv);
+}
+
+
+template bool cineon::Codec::Read<cineon::U8>(const Header &, ElementReadStream *, const Block &, U8 *);
+template bool cineon::Codec::Read<cineon::U16>(const Header &, ElementReadStream *, const Block &, U16 *);
+template bool cineon::Codec::Read<cineon::U32>(const Header &, ElementReadStream *, const Block &, U32 *);
+template bool cineon::Codec::Read<cineon::U64>(const Header &, ElementReadStream *, const Block &, U64 *);
+template bool cineon::Codec::Read<cineon::R32>(const Header &, ElementReadStream *, const Block &, R32 *);
+template bool cineon::Codec::Read<cineon::R16>(const Header &, ElementReadStream *, const Block &, R16 *);
+
+
+bool cineon::Codec::Read(const Header &dpxHeader, ElementReadStream *fd, const Block &block, void *data, const DataSize size,
+						 const ReadOptions &options)
+{
+	// components of the image and of the buffer's pixels, which may reorder or leave out some
+	const int numberOfComponents = dpxHeader.NumberOfElements();
+	const int channelCount = (options.channelCount ? options.channelCount : numberOfComponents);
+	if (channelCount < 0 || channelCount > MAX_ELEMENTS)
+		return false;
+
+	// position of each image component in the buffer's pixels, -1 if it is left out
+	int positions[MAX_ELEMENTS];
+	bool repeated = false;
+	for (int i = 0; i < numberOfComponents; i++)
+		positions[i] = -1;
+	for (int i = 0; i < channelCount; i++)
+	{
+		const int channel = (options.channelCount ? options.channels[i] : i);
+		if (channel < 0 || channel >= numberOfComponents)
+			return false;
+		if (positions[channel] >= 0)
+			repeated = true;
+		positions[channel] = i;
+	}
+
+	// 10:10:10:2 pixels are packed from three kWord components, with the alpha in the bits left over
+	const bool planar = (options.planes[0] != 0);
+	const bool packed = (options.format != kComponents);
+	if (packed && (size != kInt || channelCount != 3 || options.alpha || planar))
+		return false;
+	const DataSize componentSize = (packed ? kWord : size);
+
+	// bytes in a component, in a tightly packed pixel of the buffer's components and in a pixel
+	// of the buffer with the added alpha, planar buffers hold a single component of the pixel in
+	// each plane
+	const int componentBytes = Header::DataSizeByteCount(componentSize);
+	const int pixelBytes = channelCount * componentBytes;
+	int outputBytes = pixelBytes + (options.alpha ? componentBytes : 0);
+	if (packed)
+		outputBytes = sizeof(U32);
+	else if (planar)
+		outputBytes = componentBytes;
+
+	// proxies keep every proxy-th line and pixel of the block, or the average of each run of pixels
+	const int proxy = options.proxy;
+	if (proxy != 1 && proxy != 2 && proxy != 4 && proxy != 8)
+		return false;
+
+	// buffer layout
+	const int blockPixels = block.x2 - block.x1 + 1;
+	const int pixels = (blockPixels + proxy - 1) / proxy;
+	const int pixelStride = (options.pixelStride ? options.pixelStride : outputBytes);
+	const long rowPitch = (options.rowPitch ? options.rowPitch : long(pixels) * pixelStride);
+
+	// pixels and lines may not overlap
+	if (pixelStride < outputBytes || (rowPitch < 0 ? -rowPitch : rowPitch) < long(pixels - 1) * pixelStride + outputBytes)
+		return false;
+
+	// the alpha and the planes are stored as components of the buffer type
+	if ((options.alpha || planar) && (pixelStride % componentBytes) != 0)
+		return false;
+	if (packed && (pixelStride % int(sizeof(U32))) != 0)
+		return false;
+
+	// images stored with their pixels or their lines reversed are decoded into the buffer from
+	// the end of its lines or from its last line up, the pixels and lines of the ones stored
+	// top to bottom or bottom to top have to be transposed by the Reader
+	const Orientation orientation = (options.orient ? dpxHeader.ImageOrientation() : kLeftToRightTopToBottom);
+	if (orientation >= kTopToBottomLeftToRight && orientation <= kBottomToTopRightToLeft)
+		return false;
+	const bool mirror = (orientation == kRightToLeftTopToBottom || orientation == kRightToLeftBottomToTop);
+	const bool flip = (orientation == kLeftToRightBottomToTop || orientation == kRightToLeftBottomToTop);
+	const int lines = (block.y2 - block.y1) / proxy + 1;
+	const long start = (flip ? long(lines - 1) * rowPitch : 0) + (mirror ? long(pixels - 1) * pixelStride : 0);
+	const int pixelStep = (mirror ? -pixelStride : pixelStride);
+	const long lineStep = (flip ? -rowPitch : rowPitch);
+
+	// every component needs its plane
+	const int planeCount = channelCount + (options.alpha ? 1 : 0);
+	if (planar)
+	{
+		for (int i = 0; i < planeCount; i++)
+			if (options.planes[i] == 0)
+				return false;
+	}
+
+	// code value conversion, the first element's table being the one the other elements fall
+	// back on it cannot be left out
+	const bool lookup = HasLookup(options);
+	if (lookup && options.lookup[0] == 0)
+		return false;
+
+	const void *tables[MAX_ELEMENTS];
+	int tableCount = 0;
+	if (options.logToLinear)
+	{
+		// one conversion at a time
+		if (lookup)
+			return false;
+
+		tables[0] = this->LinearTable(dpxHeader, componentSize, options);
+		if (tables[0] == 0)
+			return false;
+		tableCount = 1;
+	}
+	else if (lookup)
+	{
+		// elements without a table of their own use the first one, which is only long enough
+		// for the code values of elements of its bit depth
+		tables[0] = options.lookup[0];
+		tableCount = 1;
+		for (int i = 1; i < numberOfComponents; i++)
+		{
+			if (options.lookup[i] == 0 && dpxHeader.BitDepth(i) != dpxHeader.BitDepth(0))
+				return false;
+			tables[i] = (options.lookup[i] ? options.lookup[i] : options.lookup[0]);
+			if (tables[i] != tables[0])
+				tableCount = numberOfComponents;
+		}
+	}
+
+	// colour transforms of the first three components
+	if (options.matrix && MatrixSupported(componentSize, numberOfComponents) == false)
+		return false;
+	if (options.cube && (numberOfComponents < 3 || options.cubeSize < 2 ||
+		(componentSize != kByte && componentSize != kWord && componentSize != kFloat && componentSize != kHalf)))
+		return false;
+
+	// scanline buffer
+	if (this->scanline == 0)
+		this->AllocateScanline(dpxHeader);
+
+	// the elements of channel interleaved images are read straight into their planes, a run of
+	// lines of one element at a time, the alpha plane is filled afterwards; the planes being
+	// stepped through in components, a row pitch that is not a whole number of them is left
+	// to the line by line path
+	if (planar && dpxHeader.ImageInterleave() == kChannel && proxy == 1 && !repeated && options.matrix == 0 && options.cube == 0 &&
+		(lineStep % componentBytes) == 0)
+	{
+		U8 *targets[MAX_ELEMENTS];
+		for (int i = 0; i < numberOfComponents; i++)
+			targets[i] = (positions[i] >= 0 ? reinterpret_cast<U8 *>(options.planes[positions[i]]) + start : 0);
+
+		if (this->ReadPlanes(dpxHeader, fd, block, size, targets, pixelStep / componentBytes, lineStep / componentBytes,
+							 tables, tableCount) == false)
+			return false;
+
+		if (options.alpha)
+			return FillPlane(size, reinterpret_cast<U8 *>(options.planes[channelCount]) + start, pixels, lines, pixelStep, lineStep,
+							 options.alphaValue);
+		return true;
+	}
+
+	// line and channel interleaved images are decoded a band of lines at a time, so that their
+	// elements are laid out once a band and the lines of each element are read one after the other
+	const bool banded = (proxy == 1 && (dpxHeader.ImageInterleave() == kLine || dpxHeader.ImageInterleave() == kChannel));
+	const int bandLines = (banded ? ELEMENT_BAND_LINES : 1);
+
+	// the components are reordered as they are decoded, converting only the ones the buffer
+	// takes, unless the colour transforms need the whole pixel, a component is repeated or a
+	// band of lines is decoded, then the decoded line is gathered into the buffer's order afterwards
+	const bool reorder = (options.channelCount != 0);
+	const bool gather = reorder && (repeated || options.matrix || options.cube || banded);
+
+	// three element 10-bit filled images hold a whole pixel in each word, which only needs
+	// its bits moved around to become a 10:10:10:2 pixel
+	const Packing packing = dpxHeader.ImagePacking();
+	bool filledPixels = packed && proxy == 1 && numberOfComponents == 3 && dpxHeader.BitDepth(0) == 10 && dpxHeader.ConsistentBitDepth() &&
+		dpxHeader.ImageInterleave() != kLine && dpxHeader.ImageInterleave() != kChannel &&
+		(packing == kLongWordLeft || packing == kLongWordRight) && tableCount == 0 && options.matrix == 0 && options.cube == 0;
+	for (int i = 0; i < numberOfComponents; i++)
+		if (positions[i] != i)
+			filledPixels = false;
+	const U32 alpha = PixelAlpha(options.alphaValue);
+
+	// components in a pixel of the decoded line, in the image's order unless they are
+	// reordered as they are decoded; the kernels address the line in the image's components
+	// whichever ones they convert, so it has room for all of them
+	const int lineComponents = ((reorder && !gather) ? channelCount : numberOfComponents);
+	const size_t decodedSize = size_t(blockPixels) * numberOfComponents * componentBytes;
+
+	// tightly packed pixels at full resolution are decoded straight into the buffer, as long as
+	// a band's lines follow each other in it and no component is left out, otherwise the line is
+	// decoded first, reduced to the proxy, gathered into the buffer's order and spread out to the
+	// pixel stride or to the planes, adding the alpha
+	const bool spread = (packed || planar || pixelStep != pixelBytes);
+	const bool direct = (proxy == 1 && !gather && !spread && lineComponents == numberOfComponents &&
+						 (bandLines == 1 || lineStep == long(decodedSize)));
+	U8 *decoded = 0;
+	U8 *gathered = 0;
+	if (!direct)
+	{
+		decoded = this->LineBuffer(decodedSize * bandLines + ((gather && spread) ? size_t(pixels) * pixelBytes : 0));
+		gathered = decoded + decodedSize * bandLines;
+	}
+
+	U8 *dst = reinterpret_cast<U8 *>(data) + start;
+	U8 *band = 0;
+	long lineOffset = start;
+	for (int y = block.y1, row = 0; y <= block.y2; y += proxy, row++, dst += lineStep, lineOffset += lineStep)
+	{
+		const Block lineBlock(block.x1, y, block.x2, y);
+
+		if (filledPixels)
+		{
+			// the words are repacked where they are read, in the buffer unless it has a pixel stride
+			U32 *words = (pixelStep == int(sizeof(U32)) ? reinterpret_cast<U32 *>(dst) : this->scanline);
+			if (Read10bitFilledPixels(dpxHeader, fd, lineBlock, words) == false)
+				return false;
+			RepackFilledPixels(words, pixels, (packing == kLongWordLeft ? PADDINGBITS_10BITFILLEDMETHODA : PADDINGBITS_10BITFILLEDMETHODB),
+							   options.format, alpha);
+			if (words == this->scanline)
+				StridePixels(reinterpret_cast<U8 *>(words), dst, pixels, sizeof(U32), pixelStep);
+			continue;
+		}
+
+		// decode the line, or the band of lines it starts, the following stages work on it while
+		// it is still in the cache
+		if (row % bandLines == 0)
+		{
+			const Block bandBlock(block.x1, y, block.x2, std::min(y + bandLines - 1, block.y2));
+			band = (direct ? dst : decoded);
+			if (this->ReadLine(dpxHeader, fd, bandBlock, band, componentSize, tables, tableCount,
+							   ((reorder && !gather) ? positions : 0), channelCount) == false)
+				return false;
+		}
+		U8 *line = band + (row % bandLines) * (direct ? lineStep : long(decodedSize));
+
+		if (proxy > 1)
+			ReduceColumns(componentSize, line, blockPixels, lineComponents, proxy, options.proxyAverage);
+
+		if (options.matrix)
+			ApplyMatrix(componentSize, line, line, pixels, numberOfComponents, options.matrix);
+		if (options.cube)
+			ApplyCube(componentSize, line, pixels, numberOfComponents, options.cube, options.cubeSize);
+
+		// tightly packed pixels of the buffer's components
+		U8 *out = line;
+		if (gather)
+		{
+			out = (spread ? gathered : dst);
+			SwizzlePixels(componentBytes, line, out, pixels, numberOfComponents, options.channels, channelCount);
+		}
+
+		if (packed)
+			PackPixels(reinterpret_cast<U16 *>(out), dst, pixels, pixelStep, options.format, alpha);
+		else if (planar)
+		{
+			U8 *planes[MAX_ELEMENTS + 1];
+			for (int i = 0; i < planeCount; i++)
+				planes[i] = reinterpret_cast<U8 *>(options.planes[i]) + lineOffset;
+			ScatterPlanes(size, out, planes, pixels, channelCount, pixelStep, options.alpha, options.alphaValue);
+		}
+		else if (options.alpha)
+			StridePixels(size, out, dst, pixels, channelCount, pixelStep, options.alphaValue);
+		else if (out != dst)
+			StridePixels(out, dst, pixels, pixelBytes, pixelStep);
+	}
+
+	return true;
+}
@@ -38,6 +38,7 @@
 
 
 #include "Cineon.h"
+#include "PrintingDensity.h"
 
 
 namespace cineon
@@ -80,8 +81,106 @@ namespace cineon
 						  void *data,
 						  const DataSize size);
 
+		/*!
+		 * \brief read data into a typed buffer
+		 *
+		 * The conversion to the buffer type is chosen when compiling, U8, U16, U32, U64, R32
+		 * and R16 buffers are instantiated.
+		 *
+		 * \param dpxHeader dpx header information
+		 * \param fd field descriptor
+		 * \param block image area to read
+		 * \param data buffer
+		 * \return success
+		 */
+		template <typename BUF>
+		bool Read(const Header &dpxHeader,
+				  ElementReadStream *fd,
+				  const Block &block,
+				  BUF *data);
+
+		/*!
+		 * \brief read data into a buffer with the given layout
+		 * \param dpxHeader dpx header information
+		 * \param fd field descriptor
+		 * \param block image area to read
+		 * \param data buffer
+		 * \param size size of the buffer component
+		 * \param options layout of the buffer
+		 * \return success
+		 */
+		virtual bool Read(const Header &dpxHeader,
+						  ElementReadStream *fd,
+						  const Block &block,
+						  void *data,
+						  const DataSize size,
+						  const ReadOptions &options);
+
 	protected:
+		/*!
+		 * \brief allocate the scanline buffer for the image
+		 * \param dpxHeader dpx header information
+		 */
+		void AllocateScanline(const Header &dpxHeader);
+
+		/*!
+		 * \brief make sure the line buffer holds at least size bytes
+		 * \param size byte count
+		 * \return line buffer
+		 */
+		U8 *LineBuffer(const size_t size);
+
+		/*!
+		 * \brief read a line, or a band of lines following each other in data when no positions
+		 *        are given, converting the code values through tables
+		 * \param dpxHeader dpx header information
+		 * \param fd field descriptor
+		 * \param block lines to read
+		 * \param data buffer, with room for the image's components in every pixel even when positions leave some out
+		 * \param size size of the buffer component
+		 * \param tables tables of the buffer component type indexed by code value
+		 * \param tableCount 0 for no tables, 1 for a table shared by all elements, otherwise one per element
+		 * \param positions position of each element's component in the pixels of the buffer, -1 to skip it, 0 to keep the pixels as they are
+		 * \param count components in a pixel of the buffer when positions are given
+		 * \return success
+		 */
+		bool ReadLine(const Header &dpxHeader, ElementReadStream *fd, const Block &block, void *data,
+					  const DataSize size, const void * const *tables, const int tableCount, const int *positions, const int count);
+
+		/*!
+		 * \brief read a block of a channel interleaved image straight into planes, an element at a time
+		 * \param dpxHeader dpx header information
+		 * \param fd field descriptor
+		 * \param block image area to read
+		 * \param size size of the buffer component
+		 * \param targets first component of each element in its plane, 0 to skip the element
+		 * \param stride components from one pixel to the next in a plane
+		 * \param pitch components from one line to the next in a plane
+		 * \param tables tables of the buffer component type indexed by code value
+		 * \param tableCount 0 for no tables, 1 for a table shared by all elements, otherwise one per element
+		 * \return success
+		 */
+		bool ReadPlanes(const Header &dpxHeader, ElementReadStream *fd, const Block &block, const DataSize size,
+						U8 * const *targets, const int stride, const long pitch, const void * const *tables, const int tableCount);
+
+		/*!
+		 * \brief log to linear table for the image, built on first use
+		 * \param dpxHeader dpx header information
+		 * \param size kFloat or kHalf
+		 * \param options conversion parameters
+		 * \return table indexed by code value, 0 if the image cannot be converted
+		 */
+		const void *LinearTable(const Header &dpxHeader, const DataSize size, const ReadOptions &options);
+
 		U32 *scanline;			//!< single scanline
+		U8 *line;				//!< single decoded line before it is stored in the caller's buffer
+		size_t lineSize;		//!< byte size of the line buffer
+
+		// log to linear table and the conversion it was built for
+		R32 *linear;			//!< linear value of each code value
+		R16 *linearHalf;		//!< same as half floats, made when first needed
+		int linearBits;			//!< bit depth of the code values
+		PrintingDensity linearConversion;	//!< printing density conversion
 
 
 	};
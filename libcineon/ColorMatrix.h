@@ -0,0 +1,107 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick A. Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick A. Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _CINEON_COLORMATRIX_H
+#define _CINEON_COLORMATRIX_H 1
+
+
+#include "BaseTypeConverter.h"
+
+
+namespace cineon
+{
+
+	// multiply the first three components of every pixel of a line by a row major 3x3 matrix,
+	// the components are normalized to 0.0 - 1.0 on the way, clamped on the way back to integer
+	// buffers, src and dst may be the same line
+	template <typename BUF>
+	void ApplyMatrix(const BUF *src, BUF *dst, const int pixels, const int noc, const R32 *matrix)
+	{
+		R32 in[3];
+		R32 out[3];
+
+		for (int i = 0; i < pixels; i++)
+		{
+			const BUF *s = src + i * noc;
+			BUF *d = dst + i * noc;
+
+			for (int c = 0; c < 3; c++)
+			{
+				BUF value = s[c];
+				BaseTypeConverter(value, in[c]);
+			}
+
+			for (int c = 0; c < 3; c++)
+				out[c] = matrix[c * 3] * in[0] + matrix[c * 3 + 1] * in[1] + matrix[c * 3 + 2] * in[2];
+
+			for (int c = 0; c < 3; c++)
+				BaseTypeConverter(out[c], d[c]);
+
+			// the remaining components go along unchanged
+			if (src != dst)
+				for (int c = 3; c < noc; c++)
+					d[c] = s[c];
+		}
+	}
+
+
+	// buffers the matrix can be applied to
+	inline bool MatrixSupported(const DataSize size, const int noc)
+	{
+		return (noc >= 3 && (size == cineon::kByte || size == cineon::kWord || size == cineon::kFloat || size == cineon::kHalf));
+	}
+
+
+	inline bool ApplyMatrix(const DataSize size, const void *src, void *dst, const int pixels, const int noc, const R32 *matrix)
+	{
+		if (size == cineon::kByte)
+			ApplyMatrix<U8>(reinterpret_cast<const U8 *>(src), reinterpret_cast<U8 *>(dst), pixels, noc, matrix);
+		else if (size == cineon::kWord)
+			ApplyMatrix<U16>(reinterpret_cast<const U16 *>(src), reinterpret_cast<U16 *>(dst), pixels, noc, matrix);
+		else if (size == cineon::kFloat)
+			ApplyMatrix<R32>(reinterpret_cast<const R32 *>(src), reinterpret_cast<R32 *>(dst), pixels, noc, matrix);
+		else if (size == cineon::kHalf)
+			ApplyMatrix<R16>(reinterpret_cast<const R16 *>(src), reinterpret_cast<R16 *>(dst), pixels, noc, matrix);
+		else
+			return false;
+
+		return true;
+	}
+
+}
+
+
+#endif
+
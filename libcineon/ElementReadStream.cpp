@@ -38,7 +38,7 @@
 #include <cassert>
 
 
-cineon::ElementReadStream::ElementReadStream(InStream *fd) : fd(fd)
+cineon::ElementReadStream::ElementReadStream(InStream *fd) : fd(fd), streamPosition(-1)
 {
 }
 
@@ -48,8 +48,25 @@ cineon::ElementReadStream::~ElementReadStream()
 }
 
 
+// forget the file position, the stream has been used by someone else
 void cineon::ElementReadStream::Reset()
 {
+	this->streamPosition = -1;
+}
+
+
+// consecutive lines are read without seeking
+bool cineon::ElementReadStream::SeekPosition(const long position)
+{
+	if (this->streamPosition == position)
+		return true;
+
+	this->streamPosition = -1;
+	if (this->fd->Seek(position, InStream::kStart) == false)
+		return false;
+	this->streamPosition = position;
+
+	return true;
 }
 
 
@@ -58,12 +75,16 @@ bool cineon::ElementReadStream::Read(const cineon::Header &dpxHeader, const long
 	long position = dpxHeader.ImageOffset() + offset;
 
 	// seek to the memory position
-	if (this->fd->Seek(position, InStream::kStart) == false)
+	if (this->SeekPosition(position) == false)
 		return false;
 
 	// read in the data, calculate buffer offset
 	if (this->fd->Read(buf, size) != size)
+	{
+		this->streamPosition = -1;
 		return false;
+	}
+	this->streamPosition += size;
 
 	// swap the bytes if different byte order
 	this->EndianDataCheck(dpxHeader, buf, size);
@@ -77,12 +98,16 @@ bool cineon::ElementReadStream::ReadDirect(const cineon::Header &dpxHeader, cons
 	long position = dpxHeader.ImageOffset() + offset;
 
 	// seek to the memory position
-	if (this->fd->Seek(position, InStream::kStart) == false)
+	if (this->SeekPosition(position) == false)
 		return false;
 
 	// read in the data, calculate buffer offset
 	if (this->fd->ReadDirect(buf, size) != size)
+	{
+		this->streamPosition = -1;
 		return false;
+	}
+	this->streamPosition += size;
 
 	// swap the bytes if different byte order
 	this->EndianDataCheck(dpxHeader, buf, size);
@@ -96,11 +121,35 @@ void cineon::ElementReadStream::EndianDataCheck(const cineon::Header &dpxHeader,
 {
 	if (dpxHeader.RequiresByteSwap())
 	{
-		// FIXME!!!
+		// elements of different bit depths are packed together in 32-bit words
+		if (dpxHeader.ConsistentBitDepth() == false)
+		{
+			cineon::EndianSwapImageBuffer<cineon::kInt>(buf, size / sizeof(U32));
+			return;
+		}
+
+		// components stored in cells are swapped a cell at a time
+		if (cineon::Header::PackingCellBits(dpxHeader.BitDepth(0), dpxHeader.ImagePacking()))
+		{
+			switch (dpxHeader.ImagePacking() & ~cineon::kPackAsManyAsPossible)
+			{
+			case cineon::kWordLeft:
+			case cineon::kWordRight:
+				cineon::EndianSwapImageBuffer<cineon::kWord>(buf, size / sizeof(U16));
+				break;
+			case cineon::kLongWordLeft:
+			case cineon::kLongWordRight:
+				cineon::EndianSwapImageBuffer<cineon::kInt>(buf, size / sizeof(U32));
+				break;
+			}
+			return;
+		}
+
 		switch (dpxHeader.BitDepth(0))
 		{
 		case 8:
 			break;
+		case 10:
 		case 12:
 			if (dpxHeader.ImagePacking() == cineon::kPacked)
 				cineon::EndianSwapImageBuffer<cineon::kInt>(buf, size / sizeof(U32));
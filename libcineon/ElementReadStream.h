@@ -56,8 +56,10 @@ namespace cineon
 
 	protected:
 		void EndianDataCheck(const cineon::Header &, void *, const size_t size);
+		bool SeekPosition(const long position);
 
 		InStream *fd;
+		long streamPosition;	//!< file position after the last read, -1 if unknown
 	};
 
 }
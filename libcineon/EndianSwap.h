@@ -112,6 +112,14 @@ void EndianSwapImageBuffer(void *data, int length)
 	case cineon::kLongLong:
 		SwapBuffer(reinterpret_cast<U64 *>(data), length);
 		break;
+
+	case cineon::kFloat:
+		SwapBuffer(reinterpret_cast<U32 *>(data), length);
+		break;
+
+	case cineon::kHalf:
+		SwapBuffer(reinterpret_cast<U16 *>(data), length);
+		break;
 	}
 }
 
@@ -134,6 +142,14 @@ inline void EndianSwapImageBuffer(DataSize size, void *data, int length)
 	case cineon::kLongLong:
 		SwapBuffer(reinterpret_cast<U64 *>(data), length);
 		break;
+
+	case cineon::kFloat:
+		SwapBuffer(reinterpret_cast<U32 *>(data), length);
+		break;
+
+	case cineon::kHalf:
+		SwapBuffer(reinterpret_cast<U16 *>(data), length);
+		break;
 	}
 }
 
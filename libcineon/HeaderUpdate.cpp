@@ -0,0 +1,126 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick A. Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick A. Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+#include <cstring>
+
+#include "Cineon.h"
+
+
+
+// the fields that describe the layout of the image data are never changed, so the header of
+// the file is only ever replaced by one of the same size
+
+bool cineon::UpdateHeader(const char *fileName, const HeaderUpdate &update, const int index)
+{
+	Header header;
+
+	InStream in;
+	if (in.Open(fileName) == false)
+		return false;
+	const bool status = header.Read(&in);
+	in.Close();
+	if (status == false)
+		return false;
+
+	if (update.fileName)
+	{
+		const char *name = fileName;
+		for (const char *p = fileName; *p; p++)
+		{
+			if (*p == '/' || *p == '\\')
+				name = p + 1;
+		}
+		header.SetFileName(name);
+	}
+
+	if (update.framePosition)
+		header.SetFramePosition(update.firstFramePosition + U32(index * update.framePositionStep));
+
+	// the edge code moves on by whole frames of perfs, a count at a time
+	if (update.filmEdgeCode)
+	{
+		const long perfs = long(update.perfsOffset) + long(index) * update.perfsPerFrame;
+		const long perfsPerCount = (update.perfsPerCount > 0 ? update.perfsPerCount : 64);
+
+		header.filmManufacturingIdCode = update.filmManufacturingIdCode;
+		header.filmType = update.filmType;
+		header.prefix = update.prefix;
+		header.count = update.count + U32(perfs / perfsPerCount);
+		header.perfsOffset = U8(perfs % perfsPerCount);
+	}
+
+	if (update.frameId)
+		header.SetFrameId(update.frameId);
+	if (update.slateInfo)
+		header.SetSlateInfo(update.slateInfo);
+	if (update.format)
+		header.SetFormat(update.format);
+	if (update.labelText)
+		header.SetLabelText(update.labelText);
+	if (update.frameRate != 0.0f)
+		header.SetFrameRate(update.frameRate);
+
+	// written back in the byte order of the file
+	OutStream out;
+	if (out.OpenForUpdate(fileName) == false)
+		return false;
+	const bool written = header.Rewrite(&out, header.RequiresByteSwap());
+	out.Close();
+
+	return written;
+}
+
+
+int cineon::UpdateHeaders(const char * const *fileNames, const int count, const HeaderUpdate &update, bool *status)
+{
+	int updated = 0;
+
+	// every file is read and rewritten on its own, the threads share nothing but the update
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic, 16) reduction(+:updated)
+#endif
+	for (int i = 0; i < count; i++)
+	{
+		const bool ok = UpdateHeader(fileNames[i], update, i);
+		if (status)
+			status[i] = ok;
+		if (ok)
+			updated++;
+	}
+
+	return updated;
+}
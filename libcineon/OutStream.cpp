@@ -33,7 +33,14 @@
  */
 
 #include <cstdio>
+#include <cstring>
 
+#ifdef WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "CineonStream.h"
 
@@ -59,6 +66,17 @@ bool OutStream::Open(const char *f)
 }
 
 
+bool OutStream::OpenForUpdate(const char *f)
+{
+	if (this->fp)
+		this->Close();
+	if ((this->fp = ::fopen(f, "r+b")) == 0)
+		return false;
+
+	return true;
+}
+
+
 void OutStream::Close()
 {
 	if (this->fp)
@@ -77,6 +95,37 @@ size_t OutStream::Write(void *buf, const size_t size)
 }
 
 
+size_t OutStream::WriteAt(void *buf, const size_t size, const long offset)
+{
+	if (this->fp == 0)
+		return 0;
+
+	// anything still buffered by the stream has to reach the file first
+	::fflush(this->fp);
+
+#ifdef WIN32
+	OVERLAPPED ov;
+	::memset(&ov, 0, sizeof(ov));
+	ov.Offset = DWORD(offset);
+
+	DWORD written = 0;
+	if (::WriteFile(HANDLE(::_get_osfhandle(::_fileno(this->fp))), buf, DWORD(size), &written, &ov) == 0)
+		return 0;
+	return written;
+#else
+	size_t written = 0;
+	while (written < size)
+	{
+		ssize_t w = ::pwrite(::fileno(this->fp), reinterpret_cast<char *>(buf) + written, size - written, offset + written);
+		if (w <= 0)
+			break;
+		written += w;
+	}
+	return written;
+#endif
+}
+
+
 bool OutStream::Seek(long offset, Origin origin)
 {
 	int o;
@@ -0,0 +1,199 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick A. Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick A. Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _CINEON_PRINTINGDENSITY_H
+#define _CINEON_PRINTINGDENSITY_H 1
+
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace cineon
+{
+
+	// undefined header values are either all bits set or 0xffffffff stored as a float
+	inline bool DefinedValue(const R32 value)
+	{
+		return (value == value && value > -1.0e9f && value < 1.0e9f);
+	}
+
+
+	// conversion between printing density code values and linear light, reference black
+	// becomes 0.0 and reference white 1.0
+	//
+	//   linear = (10^((code - white) * density / gamma) - offset) / (1 - offset)
+	//   offset = 10^((black - white) * density / gamma)
+	//
+	// code, black and white are 10-bit code values and density is the density step of
+	// a 10-bit code value, 0.002 unless the element's low and high data and quantity
+	// define it
+	struct PrintingDensity
+	{
+		R32 black;				//!< reference black
+		R32 white;				//!< reference white
+		R32 gamma;				//!< film gamma
+		R32 density;			//!< density step of a 10-bit code value
+
+		/*!
+		 * \brief set up the conversion for an element
+		 * \param header image header
+		 * \param element image element
+		 * \param referenceBlack 10-bit code value of reference black
+		 * \param referenceWhite 10-bit code value of reference white
+		 * \param filmGamma film gamma, 0 to use the header's gamma, 0.6 if undefined
+		 * \return success, false unless black is below white
+		 */
+		bool Set(const GenericHeader &header, const int element, const R32 referenceBlack, const R32 referenceWhite, const R32 filmGamma)
+		{
+			if (!(referenceBlack < referenceWhite))
+				return false;
+
+			this->black = referenceBlack;
+			this->white = referenceWhite;
+
+			this->gamma = filmGamma;
+			if (this->gamma <= 0.0f)
+			{
+				this->gamma = header.Gamma();
+				if (!DefinedValue(this->gamma) || this->gamma <= 0.0f)
+					this->gamma = 0.6f;
+			}
+
+			this->density = 0.002f;
+			const int maxCode = (1 << header.BitDepth(element)) - 1;
+			const R32 lowData = header.LowData(element);
+			const R32 highData = header.HighData(element);
+			const R32 lowQuantity = header.LowQuantity(element);
+			const R32 highQuantity = header.HighQuantity(element);
+			if (DefinedValue(lowData) && DefinedValue(highData) && DefinedValue(lowQuantity) && DefinedValue(highQuantity) &&
+				highData > lowData && highQuantity > lowQuantity)
+				this->density = (highQuantity - lowQuantity) / (highData - lowData) * maxCode / 1023.0f;
+
+			return true;
+		}
+
+		/*!
+		 * \brief linear light of a code value
+		 * \param code 10-bit code value, need not be whole
+		 * \return linear value
+		 */
+		double Linear(const double code) const
+		{
+			const double step = this->density / this->gamma;
+			const double offset = std::pow(10.0, (this->black - this->white) * step);
+			return (std::pow(10.0, (code - this->white) * step) - offset) / (1.0 - offset);
+		}
+
+		bool operator==(const PrintingDensity &pd) const
+		{
+			return (this->black == pd.black && this->white == pd.white && this->gamma == pd.gamma && this->density == pd.density);
+		}
+	};
+
+
+	// base 2 logarithm of a positive normal float to about 1e-7, the exponent taken from its bits
+	// and the mantissa's from the series of atanh, without branches or library calls so that
+	// loops calling it vectorize; other floats give finite nonsense
+	inline R32 FastLog2(const R32 value)
+	{
+		union { R32 f; U32 u; } v;
+		v.f = value;
+		const R32 exponent = R32(int(v.u >> 23) - 127);
+
+		// log2(m) = 2 / ln(2) * atanh((m - 1) / (m + 1)) for the mantissa m in [1, 2)
+		v.u = (v.u & 0x007fffff) | 0x3f800000;
+		const R32 t = (v.f - 1.0f) / (v.f + 1.0f);
+		const R32 t2 = t * t;
+		return exponent + t * (2.8853901f + t2 * (0.9617967f + t2 * (0.5770780f + t2 * (0.4121986f +
+			t2 * (0.3205989f + t2 * 0.2623083f)))));
+	}
+
+
+	// linear light to printing density code values of a bit depth, rounded to the nearest code
+	// value and clamped; the code value is guessed from the logarithm of the linear value and
+	// corrected by a step against the linear values half way between the code values
+	struct LogEncoding
+	{
+		int maxCode;			//!< largest code value
+		R32 offset;				//!< offset making linear light a power of ten of the code value
+		R32 scale;				//!< code values per octave of the offset linear light
+		R32 bias;				//!< code value of offset linear light 1.0, plus a half to round
+		R32 *halfway;			//!< the maxCode linear values half way between the code values
+
+		LogEncoding(const PrintingDensity &conversion, const int bitDepth)
+		{
+			//   10^((code - white) * density / gamma) = linear * (1 - offset) + offset
+			const double step = conversion.density / conversion.gamma;
+			const double offset = std::pow(10.0, (conversion.black - conversion.white) * step);
+
+			this->maxCode = (1 << bitDepth) - 1;
+			this->offset = R32(offset);
+			this->scale = R32(this->maxCode / (1023.0 * step * std::log(10.0) / std::log(2.0)));
+			this->bias = R32(conversion.white * this->maxCode / 1023.0 + 0.5);
+
+			this->halfway = new R32[this->maxCode];
+			for (int i = 0; i < this->maxCode; i++)
+				this->halfway[i] = R32(conversion.Linear((i + 0.5) * 1023.0 / this->maxCode));
+		}
+
+		~LogEncoding()
+		{
+			delete [] this->halfway;
+		}
+
+		U32 Encode(const R32 value) const
+		{
+			// nan and values without a logarithm guess 0, the logarithm of any float is finite
+			const R32 power = value * (1.0f - this->offset) + this->offset;
+			R32 guess = FastLog2(power) * this->scale + this->bias;
+			guess = ((power > 0.0f) & (guess > 0.0f) ? guess : 0.0f);
+			guess = (guess < R32(this->maxCode) ? guess : R32(this->maxCode));
+
+			// rounding in the guess leaves it at most a code value off near the half way points
+			int code = int(guess);
+			const R32 above = this->halfway[std::min(code, this->maxCode - 1)];
+			code += (value >= above) & (code < this->maxCode);
+			const R32 below = this->halfway[std::max(code - 1, 0)];
+			code -= (value < below) & (code > 0);
+			return U32(code);
+		}
+	};
+
+}
+
+
+#endif
+
@@ -36,15 +36,20 @@
 #include <cstring>
 #include <ctime>
 #include <cassert>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "Cineon.h"
 #include "EndianSwap.h"
 #include "ReaderInternal.h"
 #include "ElementReadStream.h"
 #include "Codec.h"
+#include "ResampleInternal.h"
 
 
-cineon::Reader::Reader() : fd(0), rio(0)
+cineon::Reader::Reader() : fd(0), rio(0), scanLine(-1), threads(1)
 {
 	// initialize all of the Codec* to NULL
 	this->codec = 0;
@@ -63,6 +68,9 @@ void cineon::Reader::Reset()
 	delete this->codec;
 	this->codec = 0;
 
+	// scanline reading
+	this->scanLine = -1;
+
 	// Element Reader
 	if (this->rio)
 	{
@@ -83,18 +91,72 @@ void cineon::Reader::SetInStream(InStream *fd)
 
 bool cineon::Reader::ReadHeader()
 {
+	// the element reader no longer knows where the stream is
+	if (this->rio)
+		this->rio->Reset();
+
 	return this->header.Read(this->fd);
 }
 
 
 bool cineon::Reader::ReadImage(void *data, const DataSize size)
 {
-	Block block(0, 0, this->header.Width()-1, this->header.Height()-1);
+	Block block(0, 0, this->header.StoredWidth()-1, this->header.StoredHeight()-1);
 	return this->ReadBlock(data, size, block);
 }
 
 
 
+// images without any packing or padding, whose components have the size of the buffer's,
+// hold whole lines exactly as the buffer does
+bool cineon::Reader::StoredAsBuffer(const DataSize size, const Block &block) const
+{
+	const int bitDepth = this->header.BitDepth(0);
+
+	// line and channel interleaved images are read an element at a time
+	const Interleave interleave = this->header.ImageInterleave();
+	const bool pixelInterleave = (interleave != kLine && interleave != kChannel);
+
+	// the elements may differ in bit depth and size, the codec then reads each one on its own
+	return (this->header.ConsistentBitDepth() && this->header.ConsistentSize() && pixelInterleave &&
+			this->header.EndOfLinePadding() == 0 &&
+			Header::PackingCellBits(bitDepth, this->header.ImagePacking()) == 0 &&
+			((bitDepth == 8 && size == cineon::kByte) ||
+			 (bitDepth == 16 && size == cineon::kWord) ||
+			 (bitDepth == 32 && size == cineon::kInt) ||
+			 (bitDepth == 64 && size == cineon::kLongLong)) &&
+			block.x1 == 0 && block.x2 == (int)(this->header.StoredWidth()-1));
+}
+
+
+bool cineon::Reader::ReadStored(void *data, const DataSize size, const Block &block)
+{
+	const int numberOfComponents = this->header.NumberOfElements();
+	const int bitDepth = this->header.BitDepth(0);
+
+	// the element reader no longer knows where the stream is
+	this->rio->Reset();
+
+	// seek to the beginning of the image block
+	if (this->fd->Seek((this->header.ImageOffset() + (block.y1 * this->header.StoredWidth() * (bitDepth / 8) * numberOfComponents)), InStream::kStart) == false)
+		return false;
+
+	// size of the image
+	const size_t imageSize = this->header.StoredWidth() * (block.y2 - block.y1 + 1) * numberOfComponents;
+	const size_t imageByteSize = imageSize * bitDepth / 8;
+
+	size_t rs = this->fd->ReadDirect(data, imageByteSize);
+	if (rs != imageByteSize)
+		return false;
+
+	// swap the bytes if different byte order
+	if (this->header.RequiresByteSwap())
+		cineon::EndianSwapImageBuffer(size, data, imageSize);
+
+	return true;
+}
+
+
 /*
 	implementation notes:
 
@@ -107,67 +169,352 @@ bool cineon::Reader::ReadImage(void *data, const DataSize size)
 
 bool cineon::Reader::ReadBlock(void *data, const DataSize size, Block &block)
 {
-	int i;
+	// check the block coordinates
+	block.Check();
+
+	// lets see if this can be done in a single fast read
+	if (this->StoredAsBuffer(size, block))
+		return this->ReadStored(data, size, block);
+
+	// determine if the encoding system is loaded
+	if (this->codec == 0)
+		// this element reader has not been used
+		this->codec = new Codec;
+
+	// read the image block
+	return this->codec->Read(this->header, this->rio, block, data, size);
+}
+
+
+template <typename BUF>
+bool cineon::Reader::ReadImage(const Span<BUF> &span)
+{
+	Block block(0, 0, this->header.StoredWidth()-1, this->header.StoredHeight()-1);
+	return this->ReadBlock(span, block);
+}
 
+
+// the data size is known when compiling, the codec reads the block with the kernels of the
+// buffer type alone
+template <typename BUF>
+bool cineon::Reader::ReadBlock(const Span<BUF> &span, Block &block)
+{
 	// check the block coordinates
 	block.Check();
 
-	// get the number of components for this element descriptor
-	const int numberOfComponents = this->header.NumberOfElements();
+	// the buffer holds the whole block
+	const size_t count = size_t(block.x2 - block.x1 + 1) * (block.y2 - block.y1 + 1) * this->header.NumberOfElements();
+	if (span.data == 0 || span.count < count)
+		return false;
 
-	// check the widths and bit depths of the image elements
-	bool consistentDepth = true;
-	bool consistentWidth = true;
-	const int bitDepth = this->header.BitDepth(0);
-	const int width = this->header.PixelsPerLine(0);
-	for (i = 1; i < numberOfComponents; i++) {
-		if (this->header.BitDepth(i) != bitDepth) {
-			consistentDepth = false;
-			if (!consistentWidth)
-				break;
+	if (this->StoredAsBuffer(BufferType<BUF>::size, block))
+		return this->ReadStored(span.data, BufferType<BUF>::size, block);
+
+	// determine if the encoding system is loaded
+	if (this->codec == 0)
+		// this element reader has not been used
+		this->codec = new Codec;
+
+	return this->codec->Read(this->header, this->rio, block, span.data);
+}
+
+
+template bool cineon::Reader::ReadImage<cineon::U8>(const Span<U8> &);
+template bool cineon::Reader::ReadImage<cineon::U16>(const Span<U16> &);
+template bool cineon::Reader::ReadImage<cineon::U32>(const Span<U32> &);
+template bool cineon::Reader::ReadImage<cineon::U64>(const Span<U64> &);
+template bool cineon::Reader::ReadImage<cineon::R32>(const Span<R32> &);
+template bool cineon::Reader::ReadImage<cineon::R16>(const Span<R16> &);
+
+template bool cineon::Reader::ReadBlock<cineon::U8>(const Span<U8> &, Block &);
+template bool cineon::Reader::ReadBlock<cineon::U16>(const Span<U16> &, Block &);
+template bool cineon::Reader::ReadBlock<cineon::U32>(const Span<U32> &, Block &);
+template bool cineon::Reader::ReadBlock<cineon::U64>(const Span<U64> &, Block &);
+template bool cineon::Reader::ReadBlock<cineon::R32>(const Span<R32> &, Block &);
+template bool cineon::Reader::ReadBlock<cineon::R16>(const Span<R16> &, Block &);
+
+
+
+bool cineon::Reader::ReadBlock(void *data, const DataSize size, Block &block, const ReadOptions &options)
+{
+	// check the block coordinates
+	block.Check();
+
+	// only images that are not stored left to right, top to bottom need reorienting
+	const Orientation orientation = this->header.ImageOrientation();
+	const bool orient = (options.orient && orientation != kLeftToRightTopToBottom && orientation != kUndefinedOrientation);
+
+	// a tightly packed buffer can use the fast read
+	const int pixelBytes = this->header.NumberOfElements() * Header::DataSizeByteCount(size);
+	const int pixels = block.x2 - block.x1 + 1;
+	if ((options.pixelStride == 0 || options.pixelStride == pixelBytes) &&
+		(options.rowPitch == 0 || options.rowPitch == long(pixels) * pixelBytes) &&
+		options.alpha == false && options.channelCount == 0 && options.format == kComponents &&
+		options.proxy == 1 && options.planes[0] == 0 &&
+		options.logToLinear == false && HasLookup(options) == false && options.matrix == 0 && options.cube == 0 && orient == false)
+		return this->ReadBlock(data, size, block);
+
+	// determine if the encoding system is loaded
+	if (this->codec == 0)
+		// this element reader has not been used
+		this->codec = new Codec;
+
+	if (orient)
+		return this->ReadOriented(data, size, block, options);
+
+	// read the image block
+	return this->codec->Read(this->header, this->rio, block, data, size, options);
+}
+
+
+// the block is found in the order of the file, images stored with reversed pixels or lines are
+// then decoded into the buffer from the end by the codec, the pixels of the ones stored top to
+// bottom or bottom to top become the lines of the buffer, they are decoded a band of lines at a
+// time, each band transposed into the buffer before the next one is decoded
+bool cineon::Reader::ReadOriented(void *data, const DataSize size, const Block &block, const ReadOptions &options)
+{
+	const Orientation orientation = this->header.ImageOrientation();
+	const bool transpose = (orientation >= kTopToBottomLeftToRight && orientation <= kBottomToTopRightToLeft);
+
+	// the pixels of the lines of the file run right to left or bottom to top, the lines
+	// themselves run bottom to top or right to left
+	const bool mirror = (orientation == kRightToLeftTopToBottom || orientation == kRightToLeftBottomToTop ||
+						 orientation == kBottomToTopLeftToRight || orientation == kBottomToTopRightToLeft);
+	const bool flip = (orientation == kLeftToRightBottomToTop || orientation == kRightToLeftBottomToTop ||
+					   orientation == kTopToBottomRightToLeft || orientation == kBottomToTopRightToLeft);
+
+	// the block in the order of the file
+	const int x1 = (transpose ? block.y1 : block.x1);
+	const int x2 = (transpose ? block.y2 : block.x2);
+	const int y1 = (transpose ? block.x1 : block.y1);
+	const int y2 = (transpose ? block.x2 : block.y2);
+	const int storedWidth = this->header.StoredWidth();
+	const int storedHeight = this->header.StoredHeight();
+	const Block stored((mirror ? storedWidth - 1 - x2 : x1), (flip ? storedHeight - 1 - y2 : y1),
+					   (mirror ? storedWidth - 1 - x1 : x2), (flip ? storedHeight - 1 - y1 : y2));
+
+	if (!transpose)
+		return this->codec->Read(this->header, this->rio, stored, data, size, options);
+
+	const int proxy = options.proxy;
+	if (proxy < 1)
+		return false;
+
+	// bytes in a pixel as the codec decodes it into a tightly packed band, and in the buffer,
+	// which holds a single component of the pixel in each plane of a planar buffer
+	const bool planar = (options.planes[0] != 0);
+	const bool packed = (options.format != kComponents);
+	const int componentBytes = Header::DataSizeByteCount(size);
+	const int components = (options.channelCount ? options.channelCount : this->header.NumberOfElements()) + (options.alpha ? 1 : 0);
+	const int pixelBytes = (packed ? int(sizeof(U32)) : components * componentBytes);
+	const int outputBytes = (planar ? componentBytes : pixelBytes);
+
+	// the pixels of the decoded lines become the lines of the buffer and the other way around
+	const int linePixels = (stored.x2 - stored.x1) / proxy + 1;
+	const int lines = (stored.y2 - stored.y1) / proxy + 1;
+	const int pixelStride = (options.pixelStride ? options.pixelStride : outputBytes);
+	const long rowPitch = (options.rowPitch ? options.rowPitch : long(lines) * pixelStride);
+	if (pixelStride < outputBytes || (rowPitch < 0 ? -rowPitch : rowPitch) < long(lines - 1) * pixelStride + outputBytes)
+		return false;
+	if (planar && (pixelStride % componentBytes) != 0)
+		return false;
+
+	// where the first pixel of the first decoded line goes, and how far apart its pixels and
+	// the following lines go
+	const long start = (mirror ? long(linePixels - 1) * rowPitch : 0) + (flip ? long(lines - 1) * pixelStride : 0);
+	const long pixelStep = (mirror ? -rowPitch : rowPitch);
+	const long lineStep = (flip ? -pixelStride : pixelStride);
+
+	// the band is decoded tightly packed in the order of the file
+	ReadOptions bandOptions = options;
+	bandOptions.rowPitch = 0;
+	bandOptions.pixelStride = 0;
+	bandOptions.orient = false;
+	for (int i = 0; i <= MAX_ELEMENTS; i++)
+		bandOptions.planes[i] = 0;
+
+	U8 *band = new U8[size_t(ORIENT_BAND_LINES) * linePixels * pixelBytes];
+
+	bool status = true;
+	for (int line = 0; line < lines; line += ORIENT_BAND_LINES)
+	{
+		const int count = std::min(ORIENT_BAND_LINES, lines - line);
+		const Block bandBlock(stored.x1, stored.y1 + line * proxy, stored.x2, stored.y1 + (line + count - 1) * proxy);
+		if (this->codec->Read(this->header, this->rio, bandBlock, band, size, bandOptions) == false)
+		{
+			status = false;
+			break;
 		}
-		if (this->header.PixelsPerLine(i) != width) {
-			consistentWidth = false;
-			if (!consistentDepth)
-				break;
+
+		const long offset = start + line * lineStep;
+		if (planar)
+		{
+			for (int c = 0; c < components; c++)
+				TransposeBand(band + c * componentBytes, pixelBytes, linePixels, count,
+							  reinterpret_cast<U8 *>(options.planes[c]) + offset, pixelStep, lineStep, componentBytes);
 		}
+		else
+			TransposeBand(band, pixelBytes, linePixels, count, reinterpret_cast<U8 *>(data) + offset, pixelStep, lineStep, pixelBytes);
 	}
 
-	// lets see if this can be done in a single fast read
-	if (consistentDepth && consistentWidth && this->header.EndOfLinePadding() == 0 &&
-		((bitDepth == 8 && size == cineon::kByte) ||
-		 (bitDepth == 16 && size == cineon::kWord) ||
-		 (bitDepth == 32 && size == cineon::kInt) ||
-		 (bitDepth == 64 && size == cineon::kLongLong)) &&
-		block.x1 == 0 && block.x2 == (int)(this->header.Width()-1))
+	delete [] band;
+
+	return status;
+}
+
+
+void cineon::Reader::SetThreadCount(const int count)
+{
+	this->threads = count;
+}
+
+
+// the destination lines are made in bands, each band reads the source lines it needs below the
+// ones the previous band already filtered across, then filters them down, so only the source
+// lines under a band are held at any time
+bool cineon::Reader::ReadResampled(void *data, const DataSize size, const int width, const int height, const ResampleFilter filter,
+								   const ReadOptions &options)
+{
+	const int sourceWidth = this->header.StoredWidth();
+	const int sourceHeight = this->header.StoredHeight();
+	if (width <= 0 || height <= 0 || sourceWidth == 0 || sourceHeight == 0)
+		return false;
+
+	// the source lines are read tightly packed, only the conversions come from the options
+	if (options.rowPitch || options.pixelStride || options.planes[0] || options.format != kComponents || options.proxy != 1 ||
+		options.orient)
+		return false;
+
+	// the source lines are read as kFloat, so lookup tables have to hold R32 entries, which
+	// only a kFloat result asks for
+	if (HasLookup(options) && size != kFloat)
+		return false;
+
+	const int noc = (options.channelCount ? options.channelCount : this->header.NumberOfElements()) + (options.alpha ? 1 : 0);
+	const int bytes = Header::DataSizeByteCount(size);
+
+	// number of threads filtering the lines
+	int threads = this->threads;
+#ifdef _OPENMP
+	if (threads <= 0)
+		threads = omp_get_max_threads();
+#else
+	threads = 1;
+#endif
+
+	const Contributions columns(filter, sourceWidth, width);
+	const Contributions lines(filter, sourceHeight, height);
+
+	// most source lines under a band
+	int bandSourceLines = 0;
+	for (int y = 0; y < height; y += RESAMPLE_BAND_LINES)
 	{
-		// seek to the beginning of the image block
-		if (this->fd->Seek((this->header.ImageOffset() + (block.y1 * this->header.Width() * (bitDepth / 8) * numberOfComponents)), InStream::kStart) == false)
-			return false;
+		const int last = std::min(y + RESAMPLE_BAND_LINES, height) - 1;
+		bandSourceLines = std::max(bandSourceLines, lines.first[last] + lines.taps - lines.first[y]);
+	}
 
-		// size of the image
-		const size_t imageSize = this->header.Width() * (block.y2 - block.y1 + 1) * numberOfComponents;
-		const size_t imageByteSize = imageSize * bitDepth / 8;
+	// source lines as read, the same lines filtered across, and the band filtered down
+	const size_t sourceLineSize = size_t(sourceWidth) * noc;
+	const size_t lineSize = size_t(width) * noc;
+	R32 *source = new R32[bandSourceLines * sourceLineSize];
+	R32 *across = new R32[bandSourceLines * lineSize];
+	R32 *band = (size == kFloat ? 0 : new R32[RESAMPLE_BAND_LINES * lineSize]);
 
-		size_t rs = this->fd->ReadDirect(data, imageByteSize);
-		if (rs != imageByteSize)
-			return false;
+	// source lines held in across
+	int heldFirst = 0;
+	int heldCount = 0;
 
-		// swap the bytes if different byte order
-		if (this->header.RequiresByteSwap())
-			cineon::EndianSwapImageBuffer(size, data, imageSize);
+	bool status = true;
+	for (int y = 0; y < height && status; y += RESAMPLE_BAND_LINES)
+	{
+		const int bandEnd = std::min(y + RESAMPLE_BAND_LINES, height);
+		const int first = lines.first[y];
+		const int end = lines.first[bandEnd - 1] + lines.taps;
+
+		// keep the lines of the previous band that this one needs too
+		int kept = 0;
+		if (first >= heldFirst && first < heldFirst + heldCount)
+		{
+			kept = std::min(heldFirst + heldCount, end) - first;
+			::memmove(across, across + (first - heldFirst) * lineSize, kept * lineSize * sizeof(R32));
+		}
+		heldFirst = first;
+		heldCount = end - first;
+
+		// read the others and filter them across
+		const int count = heldCount - kept;
+		if (count > 0)
+		{
+			Block block(0, first + kept, sourceWidth - 1, end - 1);
+			if (this->ReadBlock(source, kFloat, block, options) == false)
+			{
+				status = false;
+				break;
+			}
 
-		return true;
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(threads)
+#endif
+			for (int i = 0; i < count; i++)
+				ResampleLine(source + i * sourceLineSize, across + (kept + i) * lineSize, columns, width, noc);
+		}
+
+		// filter the band down
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(threads)
+#endif
+		for (int line = y; line < bandEnd; line++)
+		{
+			R32 *dst = (band ? band + (line - y) * lineSize : reinterpret_cast<R32 *>(data) + line * lineSize);
+			ResampleColumns(across + (lines.first[line] - heldFirst) * lineSize, dst, lines.weights + size_t(line) * lines.taps,
+							lines.taps, int(lineSize), lineSize);
+			if (band)
+				StoreLine(size, dst, reinterpret_cast<U8 *>(data) + line * lineSize * bytes, int(lineSize));
+		}
 	}
 
+	delete [] source;
+	delete [] across;
+	delete [] band;
+
+	return status;
+}
+
+
+
+bool cineon::Reader::BeginScanlines(const DataSize size)
+{
+	if (this->fd == 0 || this->header.StoredWidth() == 0 || this->header.StoredHeight() == 0)
+		return false;
 
 	// determine if the encoding system is loaded
 	if (this->codec == 0)
 		// this element reader has not been used
 		this->codec = new Codec;
 
-	// read the image block
-	return this->codec->Read(this->header, this->rio, block, data, size);
+	this->scanSize = size;
+	this->scanLine = 0;
+
+	return true;
+}
+
+
+// lines are read in order, so the element reader carries on from where the previous lines ended
+int cineon::Reader::ReadScanlines(void *data, const int count)
+{
+	if (this->scanLine < 0)
+		return -1;
+
+	const int lines = std::min(count, int(this->header.StoredHeight()) - this->scanLine);
+	if (lines <= 0)
+		return 0;
+
+	Block block(0, this->scanLine, this->header.StoredWidth() - 1, this->scanLine + lines - 1);
+	if (this->codec->Read(this->header, this->rio, block, data, this->scanSize) == false)
+		return -1;
+
+	this->scanLine += lines;
+	return lines;
 }
 
 
@@ -178,6 +525,10 @@ bool cineon::Reader::ReadUserData(unsigned char *data)
 	if (this->header.UserSize() == 0)
 		return true;
 
+	// the element reader no longer knows where the stream is
+	if (this->rio)
+		this->rio->Reset();
+
 	// seek to the beginning of the user data block
 	if (this->fd->Seek(sizeof(GenericHeader) + sizeof(IndustryHeader), InStream::kStart) == false)
 		return false;
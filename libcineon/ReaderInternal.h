@@ -38,6 +38,7 @@
 
 
 #include <algorithm>
+#include <cstring>
 #include "BaseTypeConverter.h"
 
 
@@ -45,23 +46,161 @@
 #define PADDINGBITS_10BITFILLEDMETHODB	0
 
 #define MASK_10BITPACKED				0xffc0
-#define MULTIPLIER_10BITPACKED			2
-#define REMAIN_10BITPACKED				4
 #define	REVERSE_10BITPACKED				6
 
 #define MASK_12BITPACKED				0xfff0
-#define MULTIPLIER_12BITPACKED			4
-#define REMAIN_12BITPACKED				2
 #define	REVERSE_12BITPACKED				4
 
+#define ORIENT_BAND_LINES				32
+
+#define ELEMENT_BAND_LINES				16
+
+// number of word cells moved to the top of a U16 together before they are converted
+#define WORD_CELL_CHUNK					256
+
 
 
 
 namespace cineon
 {
 
-	template <typename IR, typename BUF, int PADDINGBITS>
-	bool Read10bitFilled(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data)
+	// converters are called with each component and its index in the line, counted from the first
+	// component of the block's first pixel, ForElement() gives the converter of the components of
+	// an image element of another bit depth
+
+	// converts the components to the buffer type, components of 10 to 16 bits arrive in the
+	// most significant bits of a U16 and floating point buffers get them normalized to their
+	// own code range, so that the largest code value becomes 1.0
+	struct ComponentConvert
+	{
+		static const bool passThrough = true;		//!< buffers of the source type may be read directly
+
+		int shift;
+		R32 scale;
+
+		ComponentConvert(const int bitDepth) : shift(bitDepth <= 16 ? 16 - bitDepth : 0),
+				scale(1.0f / (bitDepth <= 16 ? (1 << bitDepth) - 1 : 0xffff)) { }
+
+		ComponentConvert ForElement(const int bitDepth) const
+		{
+			return ComponentConvert(bitDepth);
+		}
+
+		template <typename SRC, typename BUF>
+		void operator()(SRC &src, BUF &dst, const int) const
+		{
+			BaseTypeConverter(src, dst);
+		}
+
+		void operator()(U16 &src, R32 &dst, const int) const
+		{
+			dst = (src >> this->shift) * this->scale;
+		}
+
+		void operator()(U16 &src, R16 &dst, const int) const
+		{
+			dst.bits = FloatToHalf((src >> this->shift) * this->scale);
+		}
+	};
+
+
+	// replaces the components by the entry of a table indexed by code value
+	template <typename BUF>
+	struct LookupConvert
+	{
+		static const bool passThrough = false;
+
+		const BUF *table;
+		int shift;
+
+		LookupConvert(const BUF *table, const int bitDepth) : table(table), shift(bitDepth == 8 ? 0 : 16 - bitDepth) { }
+
+		LookupConvert ForElement(const int bitDepth) const
+		{
+			return LookupConvert(this->table, bitDepth);
+		}
+
+		template <typename SRC>
+		void operator()(SRC &src, BUF &dst, const int) const
+		{
+			dst = this->table[src >> this->shift];
+		}
+	};
+
+
+	// whether the options give any image element a lookup table
+	inline bool HasLookup(const ReadOptions &options)
+	{
+		for (int i = 0; i < MAX_ELEMENTS; i++)
+		{
+			if (options.lookup[i])
+				return true;
+		}
+		return false;
+	}
+
+
+	// replaces the components by the entry of their image element's table
+	template <typename BUF>
+	struct ChannelLookupConvert
+	{
+		static const bool passThrough = false;
+
+		const BUF * const *tables;
+		int channels;
+		int shift;
+
+		ChannelLookupConvert(const BUF * const *tables, const int channels, const int bitDepth) : tables(tables), channels(channels),
+				shift(bitDepth == 8 ? 0 : 16 - bitDepth) { }
+
+		ChannelLookupConvert ForElement(const int bitDepth) const
+		{
+			return ChannelLookupConvert(this->tables, this->channels, bitDepth);
+		}
+
+		template <typename SRC>
+		void operator()(SRC &src, BUF &dst, const int i) const
+		{
+			dst = this->tables[i % this->channels][src >> this->shift];
+		}
+	};
+
+
+	// passes the components on to CONV at their position among the count components of their
+	// pixel in line, skipping the components without a position, so that the pixels come out
+	// reordered or with some components left out; the kernels still hand over the slot of the
+	// component in the image's order, so line has to have room for channels components a pixel
+	template <typename BUF, typename CONV>
+	struct SwizzleConvert
+	{
+		static const bool passThrough = false;
+
+		CONV conv;
+		BUF *line;
+		int channels;
+		int count;
+		const int *positions;
+
+		SwizzleConvert(const CONV &conv, BUF *line, const int channels, const int count, const int *positions) : conv(conv), line(line),
+				channels(channels), count(count), positions(positions) { }
+
+		SwizzleConvert ForElement(const int bitDepth) const
+		{
+			return SwizzleConvert(this->conv.ForElement(bitDepth), this->line, this->channels, this->count, this->positions);
+		}
+
+		template <typename SRC>
+		void operator()(SRC &src, BUF &, const int i) const
+		{
+			const int position = this->positions[i % this->channels];
+			if (position >= 0)
+				this->conv(src, this->line[i / this->channels * this->count + position], i);
+		}
+	};
+
+
+	template <typename IR, typename BUF, int PADDINGBITS, typename CONV>
+	bool Read10bitFilled(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
 	{
 		// image height to read
 		const int height = block.y2 - block.y1 + 1;
@@ -73,41 +212,43 @@ namespace cineon
 		int eolnPad = dpxHeader.EndOfLinePadding();
 
 
+		// number of bytes in a line, every line starts with a new word
+		const long lineSize = (dpxHeader.StoredWidth() * numberOfComponents + 2) / 3 * 4;
+
+		// position of the first component within its word
+		const int index = (block.x1 * numberOfComponents) % 3;
+
 		// read in each line at a time directly into the user memory space
 		for (int line = 0; line < height; line++)
 		{
 			// first get line offset
-			long offset = (line + block.y1) * dpxHeader.Width() * numberOfComponents;
-			offset += offset % 3;
-			offset = offset / 3 * 4;
+			long offset = (line + block.y1) * lineSize;
 
 			// add in eoln padding
-			offset += line * eolnPad;
+			offset += (line + block.y1) * eolnPad;
 
 			// add in offset within the current line, rounding down so to catch any components within the word
 			offset += block.x1 * numberOfComponents / 3 * 4;
 
 
 			// get the read count in bytes, round to the 32-bit boundry
-			int readSize = (block.x2 - block.x1 + 1) * numberOfComponents;
-			readSize += readSize % 3;
-			readSize = readSize / 3 * 4;
+			int readSize = (block.x2 - block.x1 + 1) * numberOfComponents + index;
+			readSize = (readSize + 2) / 3 * 4;
 
 			// determine buffer offset
-			int bufoff = line * dpxHeader.Width() * numberOfComponents;
+			int bufoff = line * (block.x2 - block.x1 + 1) * numberOfComponents;
 
 			fd->Read(dpxHeader, offset, readBuf, readSize);
 
 			// unpack the words in the buffer
 			BUF *obuf = data + bufoff;
-			int index = (block.x1 * sizeof(U32)) % numberOfComponents;
 
 			for (int count = (block.x2 - block.x1 + 1) * numberOfComponents - 1; count >= 0; count--)
 			{
 				// unpacking the buffer backwords
 				U16 d1 = U16(readBuf[(count + index) / 3] >> ((2 - (count + index) % 3) * 10 + PADDINGBITS) & 0x3ff) << 6;
 
-				BaseTypeConverter(d1, obuf[count]);
+				conv(d1, obuf[count], count);
 			}
 		}
 
@@ -115,25 +256,25 @@ namespace cineon
 	}
 
 
-	template <typename IR, typename BUF>
-	bool Read10bitFilledMethodA(const Header &dpx, U32 *readBuf, IR *fd, const Block &block, BUF *data)
+	template <typename IR, typename BUF, typename CONV>
+	bool Read10bitFilledMethodA(const Header &dpx, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
 	{
 		// padding bits for PackedMethodA is 2
-		return Read10bitFilled<IR, BUF, PADDINGBITS_10BITFILLEDMETHODA>(dpx, readBuf, fd, block, data);
+		return Read10bitFilled<IR, BUF, PADDINGBITS_10BITFILLEDMETHODA, CONV>(dpx, readBuf, fd, block, data, conv);
 	}
 
 
-	template <typename IR, typename BUF>
-	bool Read10bitFilledMethodB(const Header &dpx, U32 *readBuf, IR *fd, const Block &block, BUF *data)
+	template <typename IR, typename BUF, typename CONV>
+	bool Read10bitFilledMethodB(const Header &dpx, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
 	{
-		return Read10bitFilled<IR, BUF, PADDINGBITS_10BITFILLEDMETHODB>(dpx, readBuf, fd, block, data);
+		return Read10bitFilled<IR, BUF, PADDINGBITS_10BITFILLEDMETHODB, CONV>(dpx, readBuf, fd, block, data, conv);
 	}
 
 
 	// 10 bit, packed data
 	// 12 bit, packed data
-	template <typename BUF, U32 MASK, int MULTIPLIER, int REMAIN, int REVERSE>
-	void UnPackPacked(U32 *readBuf, const int bitDepth, BUF *data, int count, int bufoff)
+	template <typename BUF, U32 MASK, int REVERSE, typename CONV>
+	void UnPackPacked(U32 *readBuf, const int bitDepth, BUF *data, int count, int bufoff, const int startBit, const CONV &conv)
 	{
 		// unpack the words in the buffer
 		BUF *obuf = data + bufoff;
@@ -148,26 +289,28 @@ namespace cineon
 			//		element 1 -> 4 bit shift to normalize at MSB
 			//		element 2 -> 2 bit shift to normalize at MSB
 			//		element 3 -> 0 bit shift to normalize at MSB
-			//  10 bit algorithm: (6-((count % 4)*2))
+			//  10 bit algorithm: (6-(bit % 8))
 			//      the pattern repeats every 160 bits
 			//	12 bits datasize rotates every 2 data elements
 			//		element 0 -> 4 bit shift to normalize at MSB
 			//		element 1 -> 0 bit shift to normalize at MSB
-			//  12 bit algorithm: (4-((count % 2)*4))
+			//  12 bit algorithm: (4-(bit % 8))
 			//      the pattern repeats every 96 bits
+			//  the buffer may start in the middle of a word, startBit is the bit of the first element
+			const int bit = startBit + i * bitDepth;
 
 			// first determine the word that the data element completely resides in
-			U16 *d1 = reinterpret_cast<U16 *>(reinterpret_cast<U8 *>(readBuf)+((i * bitDepth) / 8 /*bits*/));
+			U16 *d1 = reinterpret_cast<U16 *>(reinterpret_cast<U8 *>(readBuf)+(bit / 8 /*bits*/));
 
 			// place the component in the MSB and mask it for both 10-bit and 12-bit
-			U16 d2 = (*d1 << (REVERSE - ((i % REMAIN) * MULTIPLIER))) & MASK;
-			BaseTypeConverter(d2, obuf[i]);
+			U16 d2 = (*d1 << (REVERSE - (bit % 8))) & MASK;
+			conv(d2, obuf[i], i);
 		}
 	}
 
 
-	template <typename IR, typename BUF, U32 MASK, int MULTIPLIER, int REMAIN, int REVERSE>
-	bool ReadPacked(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data)
+	template <typename IR, typename BUF, U32 MASK, int REVERSE, typename CONV>
+	bool ReadPacked(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
 	{
 		// image height to read
 		const int height = block.y2 - block.y1 + 1;
@@ -178,19 +321,18 @@ namespace cineon
 		// end of line padding
 		int eolnPad = dpxHeader.EndOfLinePadding();
 
-		// data size in bits
-		// FIXME!!!
+		// data size in bits, the same for every element
 		const int dataSize = dpxHeader.BitDepth(0);
 
 		// number of bytes
-		const int lineSize = (dpxHeader.Width() * numberOfComponents * dataSize + 31) / 32;
+		const int lineSize = (dpxHeader.StoredWidth() * numberOfComponents * dataSize + 31) / 32;
 
 		// read in each line at a time directly into the user memory space
 		for (int line = 0; line < height; line++)
 		{
 			// determine offset into image element
 			long offset = (line + block.y1) * (lineSize * sizeof(U32)) +
-						(block.x1 * numberOfComponents * dataSize / 32 * sizeof(U32)) + (line * eolnPad);
+						(block.x1 * numberOfComponents * dataSize / 32 * sizeof(U32)) + ((line + block.y1) * eolnPad);
 
 			// calculate read size
 			int readSize = ((block.x2 - block.x1 + 1) * numberOfComponents * dataSize);
@@ -198,41 +340,40 @@ namespace cineon
 			readSize = ((readSize + 31) / 32) * sizeof(U32);
 
 			// calculate buffer offset
-			int bufoff = line * dpxHeader.Width() * numberOfComponents;
+			int bufoff = line * (block.x2 - block.x1 + 1) * numberOfComponents;
 
 			fd->Read(dpxHeader, offset, readBuf, readSize);
 
 			// unpack the words in the buffer
 			int count = (block.x2 - block.x1 + 1) * numberOfComponents;
-			UnPackPacked<BUF, MASK, MULTIPLIER, REMAIN, REVERSE>(readBuf, dataSize, data, count, bufoff);
+			UnPackPacked<BUF, MASK, REVERSE, CONV>(readBuf, dataSize, data, count, bufoff, block.x1 * numberOfComponents * dataSize % 32, conv);
 		}
 
 		return true;
 	}
 
 
-	template <typename IR, typename BUF>
-	bool Read10bitPacked(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data)
+	template <typename IR, typename BUF, typename CONV>
+	bool Read10bitPacked(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
 	{
-		return ReadPacked<IR, BUF, MASK_10BITPACKED, MULTIPLIER_10BITPACKED, REMAIN_10BITPACKED, REVERSE_10BITPACKED>(dpxHeader, readBuf, fd, block, data);
+		return ReadPacked<IR, BUF, MASK_10BITPACKED, REVERSE_10BITPACKED, CONV>(dpxHeader, readBuf, fd, block, data, conv);
 
 	}
 
-	template <typename IR, typename BUF>
-	bool Read12bitPacked(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data)
+	template <typename IR, typename BUF, typename CONV>
+	bool Read12bitPacked(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
 	{
-		return ReadPacked<IR, BUF, MASK_12BITPACKED, MULTIPLIER_12BITPACKED, REMAIN_12BITPACKED, REVERSE_12BITPACKED>(dpxHeader, readBuf, fd, block, data);
+		return ReadPacked<IR, BUF, MASK_12BITPACKED, REVERSE_12BITPACKED, CONV>(dpxHeader, readBuf, fd, block, data, conv);
 	}
 
 
-	template <typename IR, typename SRC, DataSize SRCTYPE, typename BUF, DataSize BUFTYPE>
-	bool ReadBlockTypes(const Header &dpxHeader, SRC *readBuf, IR *fd, const Block &block, BUF *data)
+	template <typename IR, typename SRC, DataSize SRCTYPE, typename BUF, DataSize BUFTYPE, typename CONV>
+	bool ReadBlockTypes(const Header &dpxHeader, SRC *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
 	{
 		// get the number of components for this element descriptor
 		const int numberOfComponents = dpxHeader.NumberOfElements();
 
-		// byte count component type
-		// FIXME!!!
+		// byte count component type, the same for every element
 		const int bytes = dpxHeader.ComponentByteCount(0);
 
 		// image image/height to read
@@ -245,7 +386,7 @@ namespace cineon
 			eolnPad = 0;
 
 		// image width
-		const int imageWidth = dpxHeader.Width();
+		const int imageWidth = dpxHeader.StoredWidth();
 
 		// read in each line at a time directly into the user memory space
 		for (int line = 0; line < height; line++)
@@ -253,9 +394,9 @@ namespace cineon
 
 			// determine offset into image element
 			long offset = (line + block.y1) * imageWidth * numberOfComponents * bytes +
-						block.x1 * numberOfComponents * bytes + (line * eolnPad);
+						block.x1 * numberOfComponents * bytes + ((line + block.y1) * eolnPad);
 
-			if (BUFTYPE == SRCTYPE)
+			if (BUFTYPE == SRCTYPE && CONV::passThrough)
 			{
 				fd->ReadDirect(dpxHeader, offset, reinterpret_cast<unsigned char *>(data + (width*line)), width*bytes);
 			}
@@ -265,91 +406,586 @@ namespace cineon
 
 				// convert data
 				for (int i = 0; i < width; i++)
-					BaseTypeConverter(readBuf[i], data[width*line+i]);
+					conv(readBuf[i], data[width*line+i], i);
+			}
+
+		}
+
+		return true;
+	}
+
+
+	// pass on a component of up to 16 bits as the other readers give them, 8-bit components as a
+	// U8 and the others in the most significant bits of a U16
+	template <int BITS, typename BUF, typename CONV>
+	inline void ConvertCell(const U32 value, const int depth, BUF &dst, const int index, const CONV &conv)
+	{
+		if ((BITS ? BITS : depth) == 8)
+		{
+			U8 d = U8(value);
+			conv(d, dst, index);
+		}
+		else
+		{
+			U16 d = U16(value << (16 - (BITS ? BITS : depth)));
+			conv(d, dst, index);
+		}
+	}
+
+
+	// move count words each holding a 10 or 12-bit component to their most significant bits,
+	// left justified words already have the component there and only lose the padding; the
+	// loops have no branches for the compiler to vectorize
+	inline void MoveWordsUp(const U16 *in, U16 *out, const int count, const int depth, const bool left)
+	{
+		const int up = 16 - depth;
+		const U16 mask = U16((1 << depth) - 1);
+		const U16 keep = U16(mask << up);
+
+		if (left)
+		{
+			for (int i = 0; i < count; i++)
+				out[i] = U16(in[i] & keep);
+		}
+		else
+		{
+			for (int i = 0; i < count; i++)
+				out[i] = U16((in[i] & mask) << up);
+		}
+	}
+
+
+	// components stored in cells of a byte, a word or a longword, perCell of them to a cell, the
+	// first in the most significant bits, left justified components leave the unused bits at the
+	// bottom of the cell and right justified ones at the top; components wider than a byte take
+	// CELLS byte cells, the first one most significant; startIndex is the component of the first
+	// cell the run starts at, the components go to dst as UnPackElement() puts them
+	template <int BITS, typename CELL, int CELLS, typename BUF, typename CONV>
+	void UnPackCells(const CELL *readBuf, const int bitDepth, const int perCell, const bool left, const int startIndex,
+					 const int pixels, const int *columns, BUF *dst, const int stride, const int noc, const int element, const CONV &conv)
+	{
+		const int depth = (BITS ? BITS : bitDepth);
+		const U32 mask = (U32(1) << depth) - 1;
+		const int cellBits = CELLS * int(sizeof(CELL)) * 8;
+
+		// shift of the first component of a cell, the others follow depth bits further down
+		const int top = (left ? cellBits : perCell * depth) - depth;
+
+		if (perCell == 1 && columns == 0 && CELLS == 1 && sizeof(CELL) == sizeof(U16) && depth != 8)
+		{
+			// a 10 or 12-bit component to a word, the words are moved to the most significant
+			// bits a chunk at a time, then passed on to the converter; whole chunks have a fixed
+			// count so the compiler vectorizes them at -O2 as well
+			const U16 *cell = reinterpret_cast<const U16 *>(readBuf) + startIndex;
+			U16 words[WORD_CELL_CHUNK];
+
+			for (int first = 0; first < pixels; first += WORD_CELL_CHUNK)
+			{
+				const int count = std::min(WORD_CELL_CHUNK, pixels - first);
+				if (count == WORD_CELL_CHUNK)
+					MoveWordsUp(cell + first, words, WORD_CELL_CHUNK, depth, left);
+				else
+					MoveWordsUp(cell + first, words, count, depth, left);
+
+				for (int i = 0; i < count; i++)
+					conv(words[i], dst[(first + i) * stride], (first + i) * noc + element);
+			}
+			return;
+		}
+
+		if (perCell == 1 && columns == 0)
+		{
+			// a component to a cell, the shift is the same for all of them
+			const CELL *cell = readBuf + startIndex * CELLS;
+			for (int i = 0; i < pixels; i++)
+			{
+				const U32 value = (CELLS == 1 ? U32(cell[i]) : (U32(cell[i * 2]) << 8 | cell[i * 2 + 1]));
+				ConvertCell<BITS, BUF, CONV>(value >> top & mask, depth, dst[i * stride], i * noc + element, conv);
 			}
+			return;
+		}
+
+		for (int i = 0; i < pixels; i++)
+		{
+			const int k = startIndex + (columns ? columns[i] : i);
+			const CELL *cell = readBuf + k / perCell * CELLS;
+			const U32 value = (CELLS == 1 ? U32(cell[0]) : (U32(cell[0]) << 8 | cell[1]));
+			ConvertCell<BITS, BUF, CONV>(value >> (top - k % perCell * depth) & mask, depth, dst[i * stride], i * noc + element, conv);
+		}
+	}
+
+
+	template <typename CELL, int CELLS, typename BUF, typename CONV>
+	void UnPackCells(const CELL *readBuf, const int bitDepth, const int perCell, const bool left, const int startIndex,
+					 const int pixels, const int *columns, BUF *dst, const int stride, const int noc, const int element, const CONV &conv)
+	{
+		if (bitDepth == 8)
+			UnPackCells<8, CELL, CELLS, BUF, CONV>(readBuf, bitDepth, perCell, left, startIndex, pixels, columns, dst, stride, noc, element, conv);
+		else if (bitDepth == 10)
+			UnPackCells<10, CELL, CELLS, BUF, CONV>(readBuf, bitDepth, perCell, left, startIndex, pixels, columns, dst, stride, noc, element, conv);
+		else if (bitDepth == 12)
+			UnPackCells<12, CELL, CELLS, BUF, CONV>(readBuf, bitDepth, perCell, left, startIndex, pixels, columns, dst, stride, noc, element, conv);
+		else
+			UnPackCells<0, CELL, CELLS, BUF, CONV>(readBuf, bitDepth, perCell, left, startIndex, pixels, columns, dst, stride, noc, element, conv);
+	}
+
+
+	// unpack the components of a run of cells, the packing giving the kind of cell, startIndex
+	// the component of the first cell in readBuf the run starts at
+	template <typename BUF, typename CONV>
+	bool UnPackCells(const U32 *readBuf, const int bitDepth, const Packing packing, const int startIndex, const int pixels,
+					 const int *columns, BUF *dst, const int stride, const int noc, const int element, const CONV &conv)
+	{
+		const int bits = Header::PackingCellBits(bitDepth, packing);
+		const int perCell = Header::PackingCellComponents(bitDepth, packing);
+		const int method = (packing & ~kPackAsManyAsPossible);
+		const bool left = (method == kByteLeft || method == kWordLeft || method == kLongWordLeft);
 
+		if (bits == 0)
+			return false;
+
+		if (method == kByteLeft || method == kByteRight)
+		{
+			if (bits == 8)
+				UnPackCells<U8, 1, BUF, CONV>(reinterpret_cast<const U8 *>(readBuf), bitDepth, perCell, left, startIndex, pixels, columns,
+											  dst, stride, noc, element, conv);
+			else
+				UnPackCells<U8, 2, BUF, CONV>(reinterpret_cast<const U8 *>(readBuf), bitDepth, perCell, left, startIndex, pixels, columns,
+											  dst, stride, noc, element, conv);
 		}
+		else if (method == kWordLeft || method == kWordRight)
+			UnPackCells<U16, 1, BUF, CONV>(reinterpret_cast<const U16 *>(readBuf), bitDepth, perCell, left, startIndex, pixels, columns,
+										   dst, stride, noc, element, conv);
+		else
+			UnPackCells<U32, 1, BUF, CONV>(readBuf, bitDepth, perCell, left, startIndex, pixels, columns, dst, stride, noc, element, conv);
 
 		return true;
 	}
 
 
-	template <typename IR, typename BUF>
-	bool Read12bitFilledMethodB(const Header &dpxHeader, U16 *readBuf, IR *fd, const Block &block, BUF *data)
+	// components stored in cells, every line starting with a new cell
+	template <typename IR, typename BUF, typename CONV>
+	bool ReadCells(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
 	{
 		// get the number of components for this element descriptor
 		const int numberOfComponents = dpxHeader.NumberOfElements();
 
+		const int bitDepth = dpxHeader.BitDepth(0);
+		const Packing packing = dpxHeader.ImagePacking();
+
+		// bytes of a cell and the components it holds
+		const int cellBytes = Header::PackingCellBits(bitDepth, packing) / 8;
+		const int perCell = Header::PackingCellComponents(bitDepth, packing);
+
+		// end of line padding
+		int eolnPad = dpxHeader.EndOfLinePadding();
+		if (eolnPad == ~0)
+			eolnPad = 0;
+
+		// number of bytes in a line
+		const long lineSize = Header::PackedLineByteCount(bitDepth, packing, long(dpxHeader.StoredWidth()) * numberOfComponents);
+
 		// image width & height to read
 		const int width = (block.x2 - block.x1 + 1) * numberOfComponents;
 		const int height = block.y2 - block.y1 + 1;
 
-		// width of image
-		const int imageWidth = dpxHeader.Width();
+		// the block starts in the cell of its first component
+		const long first = long(block.x1) * numberOfComponents;
+		const int startIndex = int(first % perCell);
+		const int readSize = (startIndex + width + perCell - 1) / perCell * cellBytes;
+
+		for (int line = 0; line < height; line++)
+		{
+			const long offset = (line + block.y1) * (lineSize + eolnPad) + first / perCell * cellBytes;
+			if (fd->Read(dpxHeader, offset, readBuf, readSize) == false)
+				return false;
+
+			if (UnPackCells<BUF, CONV>(readBuf, bitDepth, packing, startIndex, width, 0, data + long(line) * width, 1, 1, 0, conv) == false)
+				return false;
+		}
+
+		return true;
+	}
+
+	// unpack the components of one image element from a line of packed pixels, pixelBits bits
+	// apart from the bit of the block's first one, BITS is the element's bit depth if it is known,
+	// the components come out as the other readers give them, 8-bit ones as U8, 10 to 16-bit
+	// ones in the most significant bits of a U16 and 32-bit ones as U32, stride components apart
+	// in dst, columns gives the pixel read for each pixel of the buffer when the element is
+	// narrower than the image, the converter gets the index of the component among the noc
+	// components of each pixel of the line
+	template <int BITS, typename BUF, typename CONV>
+	void UnPackElement(const U32 *readBuf, const int bitDepth, const int startBit, const int pixelBits, const int pixels,
+					   const int *columns, BUF *dst, const int stride, const int noc, const int element, const CONV &conv)
+	{
+		const int depth = (BITS ? BITS : bitDepth);
+		const U32 mask = (depth == 32 ? 0xffffffff : (U32(1) << depth) - 1);
+
+		for (int i = 0; i < pixels; i++)
+		{
+			// the bits of a line fill each word from its least significant bit up
+			const int bit = startBit + (columns ? columns[i] : i) * pixelBits;
+			const int word = bit / 32;
+			const int shift = bit % 32;
+			U64 bits = readBuf[word];
+			if (shift + depth > 32)
+				bits |= U64(readBuf[word + 1]) << 32;
+			const U32 value = U32(bits >> shift) & mask;
+
+			const int index = i * noc + element;
+			if (depth == 8)
+			{
+				U8 d = U8(value);
+				conv(d, dst[i * stride], index);
+			}
+			else if (depth <= 16)
+			{
+				U16 d = U16(value << (16 - depth));
+				conv(d, dst[i * stride], index);
+			}
+			else
+			{
+				U32 d = value;
+				conv(d, dst[i * stride], index);
+			}
+		}
+	}
+
+
+	template <typename BUF, typename CONV>
+	bool UnPackElement(const U32 *readBuf, const int bitDepth, const int startBit, const int pixelBits, const int pixels,
+					   const int *columns, BUF *dst, const int stride, const int noc, const int element, const CONV &conv)
+	{
+		switch (bitDepth)
+		{
+		case 8:
+			UnPackElement<8, BUF, CONV>(readBuf, bitDepth, startBit, pixelBits, pixels, columns, dst, stride, noc, element, conv);
+			break;
+		case 10:
+			UnPackElement<10, BUF, CONV>(readBuf, bitDepth, startBit, pixelBits, pixels, columns, dst, stride, noc, element, conv);
+			break;
+		case 12:
+			UnPackElement<12, BUF, CONV>(readBuf, bitDepth, startBit, pixelBits, pixels, columns, dst, stride, noc, element, conv);
+			break;
+		case 16:
+			UnPackElement<16, BUF, CONV>(readBuf, bitDepth, startBit, pixelBits, pixels, columns, dst, stride, noc, element, conv);
+			break;
+		case 32:
+			UnPackElement<32, BUF, CONV>(readBuf, bitDepth, startBit, pixelBits, pixels, columns, dst, stride, noc, element, conv);
+			break;
+		default:
+			if (bitDepth < 1 || bitDepth > 16)
+				return false;
+			UnPackElement<0, BUF, CONV>(readBuf, bitDepth, startBit, pixelBits, pixels, columns, dst, stride, noc, element, conv);
+			break;
+		}
+
+		return true;
+	}
+
+
+	// pixels of elements of different bit depths are packed one component after the other, each
+	// line starting with a new word, every element is unpacked from the line by the kernel of
+	// its own bit depth through its own converter
+	template <typename IR, typename BUF, typename CONV>
+	bool ReadElementsPacked(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
+	{
+		// get the number of components for this element descriptor
+		const int numberOfComponents = dpxHeader.NumberOfElements();
+
+		// bit of each element's component in a pixel, and bits in a pixel
+		int elementBits[MAX_ELEMENTS];
+		int pixelBits = 0;
+		for (int i = 0; i < numberOfComponents; i++)
+		{
+			elementBits[i] = pixelBits;
+			pixelBits += dpxHeader.BitDepth(i);
+		}
 
-		// end of line padding (not a required data element so check for ~0)
+		// end of line padding
 		int eolnPad = dpxHeader.EndOfLinePadding();
 		if (eolnPad == ~0)
 			eolnPad = 0;
 
-		// read in each line at a time directly into the user memory space
+		// number of bytes in a line
+		const long lineSize = (long(dpxHeader.StoredWidth()) * pixelBits + 31) / 32 * sizeof(U32);
+
+		// image width & height to read
+		const int pixels = block.x2 - block.x1 + 1;
+		const int height = block.y2 - block.y1 + 1;
+
+		// the block starts in the word of its first bit
+		const long firstBit = long(block.x1) * pixelBits;
+		const int startBit = int(firstBit % 32);
+		const int readSize = int((startBit + long(pixels) * pixelBits + 31) / 32 * sizeof(U32));
+
 		for (int line = 0; line < height; line++)
 		{
-			// determine offset into image element
-			long offset = (line + block.y1) * imageWidth * numberOfComponents * 2 +
-						block.x1 * numberOfComponents * 2 + (line * eolnPad);
+			const long offset = (line + block.y1) * (lineSize + eolnPad) + firstBit / 32 * sizeof(U32);
+			if (fd->Read(dpxHeader, offset, readBuf, readSize) == false)
+				return false;
 
-			fd->Read(dpxHeader, offset, readBuf, width*2);
-
-			// convert data
-			for (int i = 0; i < width; i++)
+			BUF *obuf = data + long(line) * pixels * numberOfComponents;
+			for (int i = 0; i < numberOfComponents; i++)
 			{
-				U16 d1 = readBuf[i] << 4;
-				BaseTypeConverter(d1, data[width*line+i]);
+				const int bitDepth = dpxHeader.BitDepth(i);
+				if (UnPackElement<BUF, CONV>(readBuf, bitDepth, startBit + elementBits[i], pixelBits, pixels, 0,
+											 obuf + i, numberOfComponents, numberOfComponents, i, conv.ForElement(bitDepth)) == false)
+					return false;
 			}
 		}
 
 		return true;
 	}
 
-	template <typename IR, typename BUF, DataSize BUFTYPE>
-	bool ReadImageBlock(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data)
+
+	// bytes of a line of an image element stored on its own, as the elements of line and channel
+	// interleaved images are, elements of different bit depths are packed whatever their depth
+	inline long ElementLineSize(const Header &dpxHeader, const int element)
 	{
-		// FIXME!!!
-		const int bitDepth = dpxHeader.BitDepth(0);
-		const DataSize size = dpxHeader.ComponentDataSize(0);
+		const int bitDepth = dpxHeader.BitDepth(element);
+		const long pixels = dpxHeader.PixelsPerLine(element);
+		const Packing packing = dpxHeader.ImagePacking();
+
+		if (dpxHeader.ConsistentBitDepth())
+			return Header::PackedLineByteCount(bitDepth, packing, pixels);
+
+		return (pixels * bitDepth + 31) / 32 * sizeof(U32);
+	}
+
+
+	// pass the components of a line of an element on to dst, stride components apart
+	template <typename SRC, typename BUF, typename CONV>
+	void UnPackRun(SRC *src, const int pixels, const int *columns, BUF *dst, const int stride, const int noc, const int element,
+				   const CONV &conv)
+	{
+		for (int i = 0; i < pixels; i++)
+			conv(src[columns ? columns[i] : i], dst[i * stride], i * noc + element);
+	}
+
+
+	// read the components of a line of one image element stored on its own at lineOffset, from
+	// the element's pixel first, into dst stride components apart, with the kernel of the
+	// element's bit depth and packing
+	template <typename IR, typename BUF, typename CONV>
+	bool ReadElementRun(const Header &dpxHeader, U32 *readBuf, IR *fd, const long lineOffset, const int element, const int first,
+						const int pixels, const int *columns, BUF *dst, const int stride, const CONV &conv)
+	{
+		const int numberOfComponents = dpxHeader.NumberOfElements();
+		const int bitDepth = dpxHeader.BitDepth(element);
 		const Packing packing = dpxHeader.ImagePacking();
+		const bool consistent = dpxHeader.ConsistentBitDepth();
 
-		if (bitDepth == 10)
+		// components of the line read
+		const int span = (columns ? columns[pixels - 1] + 1 : pixels);
+
+		if (consistent && Header::PackingCellBits(bitDepth, packing))
 		{
-			if (packing == kLongWordLeft)
-				return Read10bitFilledMethodA<IR, BUF>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data));
-			else if (packing == kLongWordRight)
-				return Read10bitFilledMethodB<IR, BUF>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data));
-			else if (packing == kPacked)
-				return Read10bitPacked<IR, BUF>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data));
+			const int cellBytes = Header::PackingCellBits(bitDepth, packing) / 8;
+			const int perCell = Header::PackingCellComponents(bitDepth, packing);
+			const int startIndex = first % perCell;
+			if (fd->Read(dpxHeader, lineOffset + long(first / perCell) * cellBytes, readBuf, (startIndex + span + perCell - 1) / perCell * cellBytes) == false)
+				return false;
+
+			return UnPackCells<BUF, CONV>(readBuf, bitDepth, packing, startIndex, pixels, columns, dst, stride, numberOfComponents, element, conv);
 		}
-		else if (bitDepth == 12)
+
+		// components other than packed ones take their own data type, 10 and 12-bit ones in the
+		// most significant bits of a U16
+		if (consistent && ((packing != kPacked && bitDepth <= 16) || bitDepth == 8 || bitDepth == 16 || bitDepth == 32 || bitDepth == 64))
 		{
-			if (packing == kPacked)
-				return Read12bitPacked<IR, BUF>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data));
-			/*else if (packing == kFilledMethodB)
-				// filled method B
-				// 12 bits fill LSB of 16 bits
-				return Read12bitFilledMethodB<IR, BUF>(dpxHeader, reinterpret_cast<U16 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data));
+			const int bytes = (bitDepth <= 8 ? 1 : (bitDepth <= 16 ? 2 : bitDepth / 8));
+			if (fd->Read(dpxHeader, lineOffset + long(first) * bytes, readBuf, size_t(span) * bytes) == false)
+				return false;
+
+			if (bytes == 1)
+				UnPackRun<U8, BUF, CONV>(reinterpret_cast<U8 *>(readBuf), pixels, columns, dst, stride, numberOfComponents, element, conv);
+			else if (bytes == 2)
+				UnPackRun<U16, BUF, CONV>(reinterpret_cast<U16 *>(readBuf), pixels, columns, dst, stride, numberOfComponents, element, conv);
+			else if (bytes == 4)
+				UnPackRun<U32, BUF, CONV>(readBuf, pixels, columns, dst, stride, numberOfComponents, element, conv);
 			else
-				// filled method A
-				// 12 bits fill MSB of 16 bits
-				return ReadBlockTypes<IR, U16, kWord, BUF, BUFTYPE>(dpxHeader, reinterpret_cast<U16 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data));*/
+				UnPackRun<U64, BUF, CONV>(reinterpret_cast<U64 *>(readBuf), pixels, columns, dst, stride, numberOfComponents, element, conv);
+			return true;
+		}
+
+		if (packing != kPacked)
+			return false;
+
+		const long firstBit = long(first) * bitDepth;
+		const int startBit = int(firstBit % 32);
+		if (fd->Read(dpxHeader, lineOffset + firstBit / 32 * sizeof(U32), readBuf, (startBit + long(span) * bitDepth + 31) / 32 * sizeof(U32)) == false)
+			return false;
+
+		return UnPackElement<BUF, CONV>(readBuf, bitDepth, startBit, bitDepth, pixels, columns, dst, stride, numberOfComponents, element, conv);
+	}
+
+
+	// line interleaved images hold a line of each element after the other, channel interleaved
+	// ones all the lines of each element after the other, so the elements may differ in size and
+	// bit depth, the pixels and lines of elements smaller than the image are repeated to cover it;
+	// the block is read a band of lines at a time, the band's lines of one element after the
+	// other, so a plane is read in runs of lines while the band of the buffer stays in the cache,
+	// the components of each element go to its target, stride components apart and pitch
+	// components from one line to the next, elements without a target are not read
+	template <typename IR, typename BUF, typename CONV>
+	bool ReadElementsInterleaved(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF * const *targets,
+								 const int stride, const long pitch, const CONV &conv)
+	{
+		// get the number of components for this element descriptor
+		const int numberOfComponents = dpxHeader.NumberOfElements();
+
+		const bool channel = (dpxHeader.ImageInterleave() == kChannel);
+		const int imageWidth = dpxHeader.StoredWidth();
+		const int imageHeight = dpxHeader.StoredHeight();
+
+		// end of line padding, after each line of an element in a channel interleaved image and
+		// after the line of the last element in a line interleaved one
+		int eolnPad = dpxHeader.EndOfLinePadding();
+		if (eolnPad == ~0)
+			eolnPad = 0;
+
+		// bytes of a line of each element and where the element starts, in the lines of a line
+		// interleaved image or in the image data of a channel interleaved one
+		long lineSizes[MAX_ELEMENTS];
+		long starts[MAX_ELEMENTS];
+		long position = 0;
+		for (int i = 0; i < numberOfComponents; i++)
+		{
+			// the lines of a line interleaved image hold a line of every element
+			if (!channel && dpxHeader.LinesPerElement(i) != dpxHeader.LinesPerElement(0))
+				return false;
+
+			lineSizes[i] = ElementLineSize(dpxHeader, i);
+			starts[i] = position;
+			position += (channel ? long(dpxHeader.LinesPerElement(i)) * (lineSizes[i] + eolnPad) : lineSizes[i]);
+		}
+		const long lineSize = position + eolnPad;
+
+		// image width & height to read
+		const int pixels = block.x2 - block.x1 + 1;
+		const int height = block.y2 - block.y1 + 1;
+
+		// first pixel of each element read, and the one read for each pixel of the block
+		// when the element is narrower than the image
+		int firsts[MAX_ELEMENTS];
+		int *columns[MAX_ELEMENTS];
+		for (int i = 0; i < numberOfComponents; i++)
+		{
+			const long elementWidth = dpxHeader.PixelsPerLine(i);
+			firsts[i] = block.x1;
+			columns[i] = 0;
+			if (elementWidth != imageWidth)
+			{
+				firsts[i] = int(block.x1 * elementWidth / imageWidth);
+				columns[i] = new int[pixels];
+				for (int x = 0; x < pixels; x++)
+					columns[i][x] = int((block.x1 + x) * elementWidth / imageWidth) - firsts[i];
+			}
+		}
+
+		bool status = true;
+		for (int band = 0; band < height && status; band += ELEMENT_BAND_LINES)
+		{
+			const int bandEnd = std::min(band + ELEMENT_BAND_LINES, height);
+			for (int i = 0; i < numberOfComponents && status; i++)
+			{
+				if (targets[i] == 0)
+					continue;
+
+				const int bitDepth = dpxHeader.BitDepth(i);
+				const long elementHeight = dpxHeader.LinesPerElement(i);
+				const CONV elementConv = conv.ForElement(bitDepth);
+				for (int line = band; line < bandEnd; line++)
+				{
+					const int y = block.y1 + line;
+					const long elementLine = (elementHeight == imageHeight ? y : y * elementHeight / imageHeight);
+					const long offset = (channel ? starts[i] + elementLine * (lineSizes[i] + eolnPad) : elementLine * lineSize + starts[i]);
+
+					if (ReadElementRun<IR, BUF, CONV>(dpxHeader, readBuf, fd, offset, i, firsts[i], pixels, columns[i],
+													  targets[i] + line * pitch, stride, elementConv) == false)
+					{
+						status = false;
+						break;
+					}
+				}
+			}
 		}
+
+		for (int i = 0; i < numberOfComponents; i++)
+			delete [] columns[i];
+
+		return status;
+	}
+
+
+	template <typename IR, typename BUF, typename CONV>
+	bool ReadElementsInterleaved(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
+	{
+		// every element goes to its component of the pixels
+		const int numberOfComponents = dpxHeader.NumberOfElements();
+		BUF *targets[MAX_ELEMENTS];
+		for (int i = 0; i < numberOfComponents; i++)
+			targets[i] = data + i;
+
+		return ReadElementsInterleaved<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, targets, numberOfComponents,
+													  long(block.x2 - block.x1 + 1) * numberOfComponents, conv);
+	}
+
+
+	template <typename IR, typename BUF, DataSize BUFTYPE, typename CONV>
+	bool ReadImageBlock(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, BUF *data, const CONV &conv)
+	{
+		// elements of different bit depths are packed
+		if (dpxHeader.ConsistentBitDepth() == false && dpxHeader.ImagePacking() != kPacked)
+			return false;
+
+		// the elements of line and channel interleaved images are read one at a time
+		const Interleave interleave = dpxHeader.ImageInterleave();
+		if (interleave == kLine || interleave == kChannel)
+			return ReadElementsInterleaved<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, data, conv);
+
+		// the pixels of pixel interleaved elements hold a component of every element, so the
+		// elements cannot differ in size
+		if (dpxHeader.ConsistentSize() == false)
+			return false;
+
+		// elements of different bit depths are read one at a time
+		if (dpxHeader.ConsistentBitDepth() == false)
+			return ReadElementsPacked<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, data, conv);
+
+		// all the elements have the bit depth of the first one from here on
+		const int bitDepth = dpxHeader.BitDepth(0);
+		const DataSize size = dpxHeader.ComponentDataSize(0);
+		const Packing packing = dpxHeader.ImagePacking();
+
+		// components stored in cells of a byte, a word or a longword, the 10-bit components filling
+		// longwords three at a time have readers of their own
+		if (bitDepth == 10 && packing == kLongWordLeft)
+			return Read10bitFilledMethodA<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data), conv);
+		else if (bitDepth == 10 && packing == kLongWordRight)
+			return Read10bitFilledMethodB<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data), conv);
+		else if (Header::PackingCellBits(bitDepth, packing))
+			return ReadCells<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data), conv);
+		else if (bitDepth == 10 && packing == kPacked)
+			return Read10bitPacked<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data), conv);
+		else if (bitDepth == 12 && packing == kPacked)
+			return Read12bitPacked<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, reinterpret_cast<BUF *>(data), conv);
+		else if (packing == kPacked && bitDepth < 16 && bitDepth != 8)
+			// other bit depths are unpacked by the kernels of elements of different bit depths
+			return ReadElementsPacked<IR, BUF, CONV>(dpxHeader, readBuf, fd, block, data, conv);
+		else if (bitDepth == 10 || bitDepth == 12)
+			// outside of the packing methods, 10 and 12-bit components fill the most significant
+			// bits of a word
+			return ReadBlockTypes<IR, U16, kWord, BUF, BUFTYPE, CONV>(dpxHeader, reinterpret_cast<U16 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data), conv);
 		else if (size == cineon::kByte)
-			return ReadBlockTypes<IR, U8, kByte, BUF, BUFTYPE>(dpxHeader, reinterpret_cast<U8 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data));
+			return ReadBlockTypes<IR, U8, kByte, BUF, BUFTYPE, CONV>(dpxHeader, reinterpret_cast<U8 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data), conv);
 		else if (size == cineon::kWord)
-			return ReadBlockTypes<IR, U16, kWord, BUF, BUFTYPE>(dpxHeader, reinterpret_cast<U16 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data));
+			return ReadBlockTypes<IR, U16, kWord, BUF, BUFTYPE, CONV>(dpxHeader, reinterpret_cast<U16 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data), conv);
 		else if (size == cineon::kInt)
-			return ReadBlockTypes<IR, U32, kInt, BUF, BUFTYPE>(dpxHeader, reinterpret_cast<U32 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data));
+			return ReadBlockTypes<IR, U32, kInt, BUF, BUFTYPE, CONV>(dpxHeader, reinterpret_cast<U32 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data), conv);
 		else if (size == cineon::kLongLong)
-			return ReadBlockTypes<IR, U64, kLongLong, BUF, BUFTYPE>(dpxHeader, reinterpret_cast<U64 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data));
+			return ReadBlockTypes<IR, U64, kLongLong, BUF, BUFTYPE, CONV>(dpxHeader, reinterpret_cast<U64 *>(readBuf), fd, block, reinterpret_cast<BUF *>(data), conv);
 
 		// should not reach here
 		return false;
@@ -358,19 +994,597 @@ namespace cineon
 	template <typename IR>
 	bool ReadImageBlock(const Header &dpxHeader, U32 *readBuf, IR *fd, const Block &block, void *data, const DataSize size)
 	{
+		const ComponentConvert conv(dpxHeader.BitDepth(0));
+
 		if (size == cineon::kByte)
-			return ReadImageBlock<IR, U8, cineon::kByte>(dpxHeader, readBuf, fd, block, reinterpret_cast<U8 *>(data));
+			return ReadImageBlock<IR, U8, cineon::kByte>(dpxHeader, readBuf, fd, block, reinterpret_cast<U8 *>(data), conv);
 		else if (size == cineon::kWord)
-			return ReadImageBlock<IR, U16, cineon::kWord>(dpxHeader, readBuf, fd, block, reinterpret_cast<U16 *>(data));
+			return ReadImageBlock<IR, U16, cineon::kWord>(dpxHeader, readBuf, fd, block, reinterpret_cast<U16 *>(data), conv);
 		else if (size == cineon::kInt)
-			return ReadImageBlock<IR, U32, cineon::kInt>(dpxHeader, readBuf, fd,  block, reinterpret_cast<U32 *>(data));
+			return ReadImageBlock<IR, U32, cineon::kInt>(dpxHeader, readBuf, fd,  block, reinterpret_cast<U32 *>(data), conv);
 		else if (size == cineon::kLongLong)
-			return ReadImageBlock<IR, U64, cineon::kLongLong>(dpxHeader, readBuf, fd, block, reinterpret_cast<U64 *>(data));
+			return ReadImageBlock<IR, U64, cineon::kLongLong>(dpxHeader, readBuf, fd, block, reinterpret_cast<U64 *>(data), conv);
+		else if (size == cineon::kFloat)
+			return ReadImageBlock<IR, R32, cineon::kFloat>(dpxHeader, readBuf, fd, block, reinterpret_cast<R32 *>(data), conv);
+		else if (size == cineon::kHalf)
+			return ReadImageBlock<IR, R16, cineon::kHalf>(dpxHeader, readBuf, fd, block, reinterpret_cast<R16 *>(data), conv);
 
 		// should not reach here
 		return false;
 	}
 
+
+	// tetrahedral interpolation of an RGB triplet in a 3D lookup table of size^3 RGB
+	// triplets, red changing fastest
+	inline void CubeLookup(const R32 *cube, const int size, R32 rgb[3])
+	{
+		const R32 scale = R32(size - 1);
+		int index[3];
+		R32 f[3];
+
+		for (int c = 0; c < 3; c++)
+		{
+			// clamp to the cube, nan ends up at 0
+			R32 v = rgb[c] * scale;
+			if (!(v > 0.0f))
+				v = 0.0f;
+			else if (v > scale)
+				v = scale;
+
+			// the last cell includes the far side of the cube
+			index[c] = std::min(int(v), size - 2);
+			f[c] = v - index[c];
+		}
+
+		// offsets of the neighbouring entries along each axis
+		const int dr = 3;
+		const int dg = 3 * size;
+		const int db = 3 * size * size;
+
+		const R32 *c000 = cube + index[0] * dr + index[1] * dg + index[2] * db;
+		const R32 *c111 = c000 + dr + dg + db;
+
+		// the tetrahedron runs from c000 along the axis of the largest fraction, then along the
+		// axis of the middle one to c111, picked without branches as the fractions of
+		// neighbouring pixels hardly predict each other
+		const R32 fr = f[0], fg = f[1], fb = f[2];
+		const bool rg = fr > fg;
+		const bool rb = fr > fb;
+		const bool gb = fg > fb;
+		const int largest = (rg ? (rb ? dr : db) : (gb ? dg : db));
+		const int smallest = (rg ? (gb ? db : dg) : (rb ? db : dr));
+		const R32 *c1 = c000 + largest;
+		const R32 *c2 = c111 - smallest;
+
+		const R32 fmax = std::max(fr, std::max(fg, fb));
+		const R32 fmin = std::min(fr, std::min(fg, fb));
+		const R32 fmid = fr + fg + fb - fmax - fmin;
+		const R32 w0 = 1.0f - fmax;
+		const R32 w1 = fmax - fmid;
+		const R32 w2 = fmid - fmin;
+		const R32 w3 = fmin;
+
+		for (int c = 0; c < 3; c++)
+			rgb[c] = w0 * c000[c] + w1 * c1[c] + w2 * c2[c] + w3 * c111[c];
+	}
+
+
+	// run the first three components of each pixel of a decoded line through a 3D lookup table,
+	// the components are taken and put back normalized to 0.0 - 1.0
+	template <typename BUF>
+	void ApplyCube(BUF *line, const int pixels, const int noc, const R32 *cube, const int size)
+	{
+		R32 rgb[3];
+
+		for (int i = 0; i < pixels; i++)
+		{
+			BUF *pixel = line + i * noc;
+			for (int c = 0; c < 3; c++)
+				BaseTypeConverter(pixel[c], rgb[c]);
+
+			CubeLookup(cube, size, rgb);
+
+			for (int c = 0; c < 3; c++)
+				BaseTypeConverter(rgb[c], pixel[c]);
+		}
+	}
+
+
+	inline bool ApplyCube(const DataSize size, void *line, const int pixels, const int noc, const R32 *cube, const int cubeSize)
+	{
+		if (size == cineon::kByte)
+			ApplyCube<U8>(reinterpret_cast<U8 *>(line), pixels, noc, cube, cubeSize);
+		else if (size == cineon::kWord)
+			ApplyCube<U16>(reinterpret_cast<U16 *>(line), pixels, noc, cube, cubeSize);
+		else if (size == cineon::kFloat)
+			ApplyCube<R32>(reinterpret_cast<R32 *>(line), pixels, noc, cube, cubeSize);
+		else if (size == cineon::kHalf)
+			ApplyCube<R16>(reinterpret_cast<R16 *>(line), pixels, noc, cube, cubeSize);
+		else
+			return false;
+
+		return true;
+	}
+
+
+	// spread a line of tightly packed pixels out to the destination pixel stride
+	inline void StridePixels(const U8 *src, U8 *dst, const int pixels, const int pixelBytes, const int pixelStride)
+	{
+		if (pixelStride == pixelBytes)
+		{
+			::memcpy(dst, src, size_t(pixels) * pixelBytes);
+			return;
+		}
+
+		for (int i = 0; i < pixels; i++)
+			::memcpy(dst + i * pixelStride, src + i * pixelBytes, pixelBytes);
+	}
+
+
+	// 2-bit alpha of 10:10:10:2 pixels
+	inline U32 PixelAlpha(const R32 value)
+	{
+		if (!(value > 0.0f))
+			return 0;
+		if (value >= 1.0f)
+			return 3;
+		return U32(value * 3.0f + 0.5f);
+	}
+
+
+	// pack a line of pixels of three U16 components, 10 bits in the most significant bits,
+	// into 10:10:10:2 pixels pixelStride bytes apart
+	inline void PackPixels(const U16 *src, U8 *dst, const int pixels, const int pixelStride, const PixelFormat format, const U32 alpha)
+	{
+		for (int i = 0; i < pixels; i++)
+		{
+			const U32 r = src[i * 3] >> 6;
+			const U32 g = src[i * 3 + 1] >> 6;
+			const U32 b = src[i * 3 + 2] >> 6;
+
+			U32 *pixel = reinterpret_cast<U32 *>(dst + i * pixelStride);
+			if (format == kA2R10G10B10)
+				*pixel = (alpha << 30) | (r << 20) | (g << 10) | b;
+			else
+				*pixel = (alpha << 30) | (b << 20) | (g << 10) | r;
+		}
+	}
+
+
+	// read a line of a three element 10-bit filled image, each word holds a pixel
+	template <typename IR>
+	bool Read10bitFilledPixels(const Header &dpxHeader, IR *fd, const Block &block, U32 *words)
+	{
+		int eolnPad = dpxHeader.EndOfLinePadding();
+		if (eolnPad == ~0)
+			eolnPad = 0;
+
+		const long offset = long(block.y1) * (dpxHeader.StoredWidth() * sizeof(U32) + eolnPad) + block.x1 * sizeof(U32);
+		return fd->Read(dpxHeader, offset, words, (block.x2 - block.x1 + 1) * sizeof(U32));
+	}
+
+
+	// turn words of three 10-bit components, the first in the most significant bits above
+	// padding bits, into 10:10:10:2 pixels in place
+	inline void RepackFilledPixels(U32 *words, const int pixels, const int padding, const PixelFormat format, const U32 alpha)
+	{
+		if (format == kA2R10G10B10)
+		{
+			// the components are in place once the padding is gone
+			for (int i = 0; i < pixels; i++)
+				words[i] = (alpha << 30) | ((words[i] >> padding) & 0x3fffffff);
+		}
+		else
+		{
+			// the first and third components swap places
+			for (int i = 0; i < pixels; i++)
+			{
+				const U32 word = words[i] >> padding;
+				words[i] = (alpha << 30) | ((word & 0x3ff) << 20) | (word & 0xffc00) | ((word >> 20) & 0x3ff);
+			}
+		}
+	}
+
+
+	// components are summed in a type wide enough for any run of proxy pixels to reduce a line
+	template <typename BUF>
+	struct ReduceSum
+	{
+		typedef U32 Type;
+
+		static Type Value(const BUF value)
+		{
+			return value;
+		}
+
+		// integer averages are rounded
+		static void Store(const Type sum, const int count, BUF &dst)
+		{
+			dst = BUF((sum + count / 2) / count);
+		}
+	};
+
+
+	template <>
+	struct ReduceSum<U64>
+	{
+		typedef U64 Type;
+
+		static Type Value(const U64 value)
+		{
+			return value;
+		}
+
+		static void Store(const Type sum, const int count, U64 &dst)
+		{
+			dst = (sum + count / 2) / count;
+		}
+	};
+
+
+	template <>
+	struct ReduceSum<U32>
+	{
+		typedef U64 Type;
+
+		static Type Value(const U32 value)
+		{
+			return value;
+		}
+
+		static void Store(const Type sum, const int count, U32 &dst)
+		{
+			dst = U32((sum + count / 2) / count);
+		}
+	};
+
+
+	template <>
+	struct ReduceSum<R32>
+	{
+		typedef R32 Type;
+
+		static Type Value(const R32 value)
+		{
+			return value;
+		}
+
+		static void Store(const Type sum, const int count, R32 &dst)
+		{
+			dst = sum / count;
+		}
+	};
+
+
+	template <>
+	struct ReduceSum<R16>
+	{
+		typedef R32 Type;
+
+		static Type Value(const R16 value)
+		{
+			return HalfToFloat(value.bits);
+		}
+
+		static void Store(const Type sum, const int count, R16 &dst)
+		{
+			dst.bits = FloatToHalf(sum / count);
+		}
+	};
+
+
+	// reduce a line of pixels of noc components in place to every factor-th pixel, or to the
+	// average of each run of factor pixels, the last run may be shorter
+	template <typename BUF>
+	void ReduceColumns(BUF *line, const int pixels, const int noc, const int factor, const bool average)
+	{
+		const int reduced = (pixels + factor - 1) / factor;
+
+		for (int i = 0; i < reduced; i++)
+		{
+			const int first = i * factor;
+			if (average == false)
+			{
+				for (int c = 0; c < noc; c++)
+					line[i * noc + c] = line[first * noc + c];
+				continue;
+			}
+
+			const int count = std::min(factor, pixels - first);
+			for (int c = 0; c < noc; c++)
+			{
+				typename ReduceSum<BUF>::Type sum = 0;
+				for (int k = 0; k < count; k++)
+					sum += ReduceSum<BUF>::Value(line[(first + k) * noc + c]);
+				ReduceSum<BUF>::Store(sum, count, line[i * noc + c]);
+			}
+		}
+	}
+
+
+	inline bool ReduceColumns(const DataSize size, void *line, const int pixels, const int noc, const int factor, const bool average)
+	{
+		switch (size)
+		{
+		case cineon::kByte:
+			ReduceColumns<U8>(reinterpret_cast<U8 *>(line), pixels, noc, factor, average);
+			break;
+		case cineon::kWord:
+			ReduceColumns<U16>(reinterpret_cast<U16 *>(line), pixels, noc, factor, average);
+			break;
+		case cineon::kInt:
+			ReduceColumns<U32>(reinterpret_cast<U32 *>(line), pixels, noc, factor, average);
+			break;
+		case cineon::kLongLong:
+			ReduceColumns<U64>(reinterpret_cast<U64 *>(line), pixels, noc, factor, average);
+			break;
+		case cineon::kFloat:
+			ReduceColumns<R32>(reinterpret_cast<R32 *>(line), pixels, noc, factor, average);
+			break;
+		case cineon::kHalf:
+			ReduceColumns<R16>(reinterpret_cast<R16 *>(line), pixels, noc, factor, average);
+			break;
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+
+	// gather the listed components of a line of pixels of noc components into pixels of count components
+	template <typename T>
+	void SwizzlePixels(const T *src, T *dst, const int pixels, const int noc, const int *channels, const int count)
+	{
+		for (int i = 0; i < pixels; i++)
+			for (int c = 0; c < count; c++)
+				dst[i * count + c] = src[i * noc + channels[c]];
+	}
+
+
+	// components are only moved, so their byte count is all that matters
+	inline bool SwizzlePixels(const int componentBytes, const U8 *src, U8 *dst, const int pixels, const int noc, const int *channels, const int count)
+	{
+		switch (componentBytes)
+		{
+		case 1:
+			SwizzlePixels<U8>(src, dst, pixels, noc, channels, count);
+			break;
+		case 2:
+			SwizzlePixels<U16>(reinterpret_cast<const U16 *>(src), reinterpret_cast<U16 *>(dst), pixels, noc, channels, count);
+			break;
+		case 4:
+			SwizzlePixels<U32>(reinterpret_cast<const U32 *>(src), reinterpret_cast<U32 *>(dst), pixels, noc, channels, count);
+			break;
+		case 8:
+			SwizzlePixels<U64>(reinterpret_cast<const U64 *>(src), reinterpret_cast<U64 *>(dst), pixels, noc, channels, count);
+			break;
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+
+	// spread a line of tightly packed pixels of noc components out to the destination pixel
+	// stride, adding a component set to alpha after each pixel
+	template <typename BUF>
+	void StridePixels(const BUF *src, U8 *dst, const int pixels, const int noc, const int pixelStride, const BUF alpha)
+	{
+		for (int i = 0; i < pixels; i++)
+		{
+			BUF *pixel = reinterpret_cast<BUF *>(dst + i * pixelStride);
+			for (int c = 0; c < noc; c++)
+				pixel[c] = src[i * noc + c];
+			pixel[noc] = alpha;
+		}
+	}
+
+
+	template <typename BUF>
+	void StridePixels(const U8 *src, U8 *dst, const int pixels, const int noc, const int pixelStride, R32 alpha)
+	{
+		BUF value;
+		BaseTypeConverter(alpha, value);
+		StridePixels<BUF>(reinterpret_cast<const BUF *>(src), dst, pixels, noc, pixelStride, value);
+	}
+
+
+	inline bool StridePixels(const DataSize size, const U8 *src, U8 *dst, const int pixels, const int noc, const int pixelStride, const R32 alpha)
+	{
+		switch (size)
+		{
+		case cineon::kByte:
+			StridePixels<U8>(src, dst, pixels, noc, pixelStride, alpha);
+			break;
+		case cineon::kWord:
+			StridePixels<U16>(src, dst, pixels, noc, pixelStride, alpha);
+			break;
+		case cineon::kInt:
+			StridePixels<U32>(src, dst, pixels, noc, pixelStride, alpha);
+			break;
+		case cineon::kLongLong:
+			StridePixels<U64>(src, dst, pixels, noc, pixelStride, alpha);
+			break;
+		case cineon::kFloat:
+			StridePixels<R32>(src, dst, pixels, noc, pixelStride, alpha);
+			break;
+		case cineon::kHalf:
+			StridePixels<R16>(src, dst, pixels, noc, pixelStride, alpha);
+			break;
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+
+	// scatter a line of tightly packed pixels of noc components to one plane per component,
+	// the pixels pixelStride bytes apart in every plane, and fill the plane after them with
+	// alpha if there is one
+	template <typename BUF>
+	void ScatterPlanes(const BUF *src, U8 * const *planes, const int pixels, const int noc, const int pixelStride, const BUF *alpha)
+	{
+		const int stride = pixelStride / int(sizeof(BUF));
+
+		for (int c = 0; c < noc; c++)
+		{
+			BUF *plane = reinterpret_cast<BUF *>(planes[c]);
+			for (int i = 0; i < pixels; i++)
+				plane[i * stride] = src[i * noc + c];
+		}
+
+		if (alpha)
+		{
+			BUF *plane = reinterpret_cast<BUF *>(planes[noc]);
+			for (int i = 0; i < pixels; i++)
+				plane[i * stride] = *alpha;
+		}
+	}
+
+
+	template <typename BUF>
+	void ScatterPlanes(const U8 *src, U8 * const *planes, const int pixels, const int noc, const int pixelStride, const bool alpha, R32 alphaValue)
+	{
+		BUF value;
+		BaseTypeConverter(alphaValue, value);
+		ScatterPlanes<BUF>(reinterpret_cast<const BUF *>(src), planes, pixels, noc, pixelStride, (alpha ? &value : 0));
+	}
+
+
+	inline bool ScatterPlanes(const DataSize size, const U8 *src, U8 * const *planes, const int pixels, const int noc, const int pixelStride,
+					const bool alpha, const R32 alphaValue)
+	{
+		switch (size)
+		{
+		case cineon::kByte:
+			ScatterPlanes<U8>(src, planes, pixels, noc, pixelStride, alpha, alphaValue);
+			break;
+		case cineon::kWord:
+			ScatterPlanes<U16>(src, planes, pixels, noc, pixelStride, alpha, alphaValue);
+			break;
+		case cineon::kInt:
+			ScatterPlanes<U32>(src, planes, pixels, noc, pixelStride, alpha, alphaValue);
+			break;
+		case cineon::kLongLong:
+			ScatterPlanes<U64>(src, planes, pixels, noc, pixelStride, alpha, alphaValue);
+			break;
+		case cineon::kFloat:
+			ScatterPlanes<R32>(src, planes, pixels, noc, pixelStride, alpha, alphaValue);
+			break;
+		case cineon::kHalf:
+			ScatterPlanes<R16>(src, planes, pixels, noc, pixelStride, alpha, alphaValue);
+			break;
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+
+	// fill a plane of lines of pixels with value, the pixels pixelStep bytes apart and the lines
+	// lineStep bytes apart
+	template <typename BUF>
+	void FillPlane(U8 *plane, const int pixels, const int lines, const long pixelStep, const long lineStep, R32 value)
+	{
+		BUF component;
+		BaseTypeConverter(value, component);
+
+		for (int y = 0; y < lines; y++)
+			for (int i = 0; i < pixels; i++)
+				*reinterpret_cast<BUF *>(plane + y * lineStep + i * pixelStep) = component;
+	}
+
+
+	inline bool FillPlane(const DataSize size, U8 *plane, const int pixels, const int lines, const long pixelStep, const long lineStep,
+						  const R32 value)
+	{
+		switch (size)
+		{
+		case cineon::kByte:
+			FillPlane<U8>(plane, pixels, lines, pixelStep, lineStep, value);
+			break;
+		case cineon::kWord:
+			FillPlane<U16>(plane, pixels, lines, pixelStep, lineStep, value);
+			break;
+		case cineon::kInt:
+			FillPlane<U32>(plane, pixels, lines, pixelStep, lineStep, value);
+			break;
+		case cineon::kLongLong:
+			FillPlane<U64>(plane, pixels, lines, pixelStep, lineStep, value);
+			break;
+		case cineon::kFloat:
+			FillPlane<R32>(plane, pixels, lines, pixelStep, lineStep, value);
+			break;
+		case cineon::kHalf:
+			FillPlane<R16>(plane, pixels, lines, pixelStep, lineStep, value);
+			break;
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+
+	// copy a band of decoded lines, their pixels bytes long and srcStride bytes apart, to the buffer
+	// where the pixels of a line go pixelStep bytes apart and the lines lineStep bytes apart, the
+	// pixels of every line at a position are copied one after the other so each band is transposed
+	// as a tile spanning a few cache lines on both sides, BYTES is the pixel size if it is known
+	template <int BYTES>
+	void TransposeBand(const U8 *src, const int srcStride, const int pixels, const int lines, U8 *dst,
+					   const long pixelStep, const long lineStep, const int bytes)
+	{
+		const long srcPitch = long(pixels) * srcStride;
+
+		for (int i = 0; i < pixels; i++)
+		{
+			const U8 *s = src + long(i) * srcStride;
+			U8 *d = dst + i * pixelStep;
+			for (int j = 0; j < lines; j++)
+				::memcpy(d + j * lineStep, s + j * srcPitch, (BYTES ? BYTES : bytes));
+		}
+	}
+
+
+	inline void TransposeBand(const U8 *src, const int srcStride, const int pixels, const int lines, U8 *dst,
+							  const long pixelStep, const long lineStep, const int bytes)
+	{
+		switch (bytes)
+		{
+		case 1:
+			TransposeBand<1>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		case 2:
+			TransposeBand<2>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		case 3:
+			TransposeBand<3>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		case 4:
+			TransposeBand<4>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		case 6:
+			TransposeBand<6>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		case 8:
+			TransposeBand<8>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		case 12:
+			TransposeBand<12>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		case 16:
+			TransposeBand<16>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		default:
+			TransposeBand<0>(src, srcStride, pixels, lines, dst, pixelStep, lineStep, bytes);
+			break;
+		}
+	}
+
 }
 
 
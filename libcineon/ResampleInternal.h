@@ -0,0 +1,214 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick A. Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick A. Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _CINEON_RESAMPLEINTERNAL_H
+#define _CINEON_RESAMPLEINTERNAL_H 1
+
+
+#include <algorithm>
+#include <cmath>
+#include "BaseTypeConverter.h"
+
+
+// number of destination lines resampled together, each band reads the source lines it needs
+#define RESAMPLE_BAND_LINES				64
+
+
+namespace cineon
+{
+
+	// radius of a filter in source pixels, when it is not stretched
+	inline R64 FilterSupport(const ResampleFilter filter)
+	{
+		return (filter == kLanczos3 ? 3.0 : 2.0);
+	}
+
+
+	inline R64 FilterWeight(const ResampleFilter filter, R64 x)
+	{
+		x = std::fabs(x);
+
+		if (filter == kLanczos3)
+		{
+			if (x < 1.0e-8)
+				return 1.0;
+			if (x >= 3.0)
+				return 0.0;
+
+			const R64 px = 3.14159265358979323846 * x;
+			return 3.0 * std::sin(px) * std::sin(px / 3.0) / (px * px);
+		}
+
+		// Mitchell-Netravali with B = C = 1/3
+		if (x < 1.0)
+			return (7.0 * x * x * x - 12.0 * x * x + 16.0 / 3.0) / 6.0;
+		if (x < 2.0)
+			return (-7.0 / 3.0 * x * x * x + 12.0 * x * x - 20.0 * x + 32.0 / 3.0) / 6.0;
+		return 0.0;
+	}
+
+
+	// the source pixels along an axis that make up each destination pixel, every destination
+	// pixel takes the same number of taps from its first source pixel on, the edge pixels
+	// standing in for the ones beyond the image
+	struct Contributions
+	{
+		int taps;				//!< source pixels of each destination pixel
+		int *first;				//!< first source pixel of each destination pixel
+		R32 *weights;			//!< taps weights of each destination pixel, adding up to 1
+
+		Contributions(const ResampleFilter filter, const int sourceSize, const int size)
+		{
+			// the filter is stretched over the source pixels when reducing
+			const R64 ratio = R64(sourceSize) / size;
+			const R64 scale = std::max(ratio, 1.0);
+			const R64 radius = FilterSupport(filter) * scale;
+
+			this->taps = std::min(int(std::ceil(2.0 * radius)) + 2, sourceSize);
+			this->first = new int[size];
+			this->weights = new R32[size_t(size) * this->taps];
+
+			R64 *w = new R64[this->taps];
+			for (int i = 0; i < size; i++)
+			{
+				const R64 center = (i + 0.5) * ratio - 0.5;
+				const int low = int(std::floor(center - radius)) + 1;
+				const int first = std::max(0, std::min(low, sourceSize - this->taps));
+
+				for (int k = 0; k < this->taps; k++)
+					w[k] = 0.0;
+
+				R64 sum = 0.0;
+				for (int j = low; j < low + this->taps; j++)
+				{
+					const R64 weight = FilterWeight(filter, (j - center) / scale);
+					w[std::max(0, std::min(j, sourceSize - 1)) - first] += weight;
+					sum += weight;
+				}
+
+				this->first[i] = first;
+				for (int k = 0; k < this->taps; k++)
+					this->weights[size_t(i) * this->taps + k] = R32(w[k] / sum);
+			}
+			delete [] w;
+		}
+
+		~Contributions()
+		{
+			delete [] this->first;
+			delete [] this->weights;
+		}
+	};
+
+
+	// resample a line of source pixels of noc components along x
+	inline void ResampleLine(const R32 *src, R32 *dst, const Contributions &columns, const int width, const int noc)
+	{
+		const int taps = columns.taps;
+
+		for (int i = 0; i < width; i++)
+		{
+			const R32 *w = columns.weights + size_t(i) * taps;
+			const R32 *s = src + columns.first[i] * noc;
+
+			for (int c = 0; c < noc; c++)
+			{
+				R32 sum = 0.0f;
+				for (int k = 0; k < taps; k++)
+					sum += w[k] * s[k * noc + c];
+				dst[i * noc + c] = sum;
+			}
+		}
+	}
+
+
+	// resample a destination line from taps lines of count components each, lineSize components apart
+	inline void ResampleColumns(const R32 *src, R32 *dst, const R32 *w, const int taps, const int count, const size_t lineSize)
+	{
+		for (int i = 0; i < count; i++)
+			dst[i] = w[0] * src[i];
+
+		for (int k = 1; k < taps; k++)
+		{
+			const R32 *s = src + k * lineSize;
+			for (int i = 0; i < count; i++)
+				dst[i] += w[k] * s[i];
+		}
+	}
+
+
+	// convert a resampled line to the buffer type
+	template <typename BUF>
+	void StoreLine(R32 *src, BUF *dst, const int count)
+	{
+		for (int i = 0; i < count; i++)
+			BaseTypeConverter(src[i], dst[i]);
+	}
+
+
+	inline bool StoreLine(const DataSize size, R32 *src, void *dst, const int count)
+	{
+		switch (size)
+		{
+		case cineon::kByte:
+			StoreLine<U8>(src, reinterpret_cast<U8 *>(dst), count);
+			break;
+		case cineon::kWord:
+			StoreLine<U16>(src, reinterpret_cast<U16 *>(dst), count);
+			break;
+		case cineon::kInt:
+			StoreLine<U32>(src, reinterpret_cast<U32 *>(dst), count);
+			break;
+		case cineon::kLongLong:
+			StoreLine<U64>(src, reinterpret_cast<U64 *>(dst), count);
+			break;
+		case cineon::kFloat:
+			StoreLine<R32>(src, reinterpret_cast<R32 *>(dst), count);
+			break;
+		case cineon::kHalf:
+			StoreLine<R16>(src, reinterpret_cast<R16 *>(dst), count);
+			break;
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+}
+
+
+#endif
+
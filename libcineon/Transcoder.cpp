@@ -0,0 +1,663 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick A. Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick A. Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(HAVE_SENDFILE) && defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+#endif
+
+#include "Cineon.h"
+#include "EndianSwap.h"
+#include "TranscoderInternal.h"
+
+
+
+// the image data is a sequence of rows, each of runs of components starting with a new word or
+// cell and followed by the end of line padding; a pixel interleaved row holds the components of
+// every element, a line interleaved one a run for each element and a channel interleaved one
+// the run of a line of one element
+
+bool cineon::Repack(InStream *in, OutStream *out, const Packing packing, const Endian order)
+{
+	Header header;
+	if (header.Read(in) == false)
+		return false;
+
+	// the code values keep their bit depth, all the elements have to share it
+	const int numberOfComponents = header.NumberOfElements();
+	if (numberOfComponents < 1 || header.ConsistentBitDepth() == false)
+		return false;
+
+	const int bitDepth = header.BitDepth(0);
+	const Packing srcPacking = header.ImagePacking();
+	RunLayout srcLayout, dstLayout;
+	if (srcLayout.Set(bitDepth, srcPacking) == false || dstLayout.Set(bitDepth, packing) == false)
+		return false;
+
+	U32 eolnPad = header.EndOfLinePadding();
+	if (eolnPad == ~U32(0))
+		eolnPad = 0;
+	U32 eoimPad = header.EndOfImagePadding();
+	if (eoimPad == ~U32(0))
+		eoimPad = 0;
+
+	// components of each run and the first run of each row
+	std::vector<int> runs;
+	std::vector<int> rowRuns;
+
+	const Interleave interleave = header.ImageInterleave();
+	if (interleave == kChannel)
+	{
+		for (int i = 0; i < numberOfComponents; i++)
+		{
+			for (U32 line = 0; line < header.LinesPerElement(i); line++)
+			{
+				rowRuns.push_back(int(runs.size()));
+				runs.push_back(int(header.PixelsPerLine(i)));
+			}
+		}
+	}
+	else if (interleave == kLine)
+	{
+		for (int i = 1; i < numberOfComponents; i++)
+		{
+			if (header.LinesPerElement(i) != header.LinesPerElement(0))
+				return false;
+		}
+
+		for (U32 line = 0; line < header.LinesPerElement(0); line++)
+		{
+			rowRuns.push_back(int(runs.size()));
+			for (int i = 0; i < numberOfComponents; i++)
+				runs.push_back(int(header.PixelsPerLine(i)));
+		}
+	}
+	else
+	{
+		if (header.ConsistentSize() == false)
+			return false;
+
+		for (U32 line = 0; line < header.StoredHeight(); line++)
+		{
+			rowRuns.push_back(int(runs.size()));
+			runs.push_back(int(header.StoredWidth() * numberOfComponents));
+		}
+	}
+
+	const int rows = int(rowRuns.size());
+	rowRuns.push_back(int(runs.size()));
+	if (rows == 0)
+		return false;
+
+	// offset of each row in the source and the destination image data
+	std::vector<long> srcRows(rows + 1, 0);
+	std::vector<long> dstRows(rows + 1, 0);
+	for (int row = 0; row < rows; row++)
+	{
+		long srcSize = eolnPad;
+		long dstSize = eolnPad;
+		for (int run = rowRuns[row]; run < rowRuns[row + 1]; run++)
+		{
+			srcSize += Header::PackedLineByteCount(bitDepth, srcPacking, runs[run]);
+			dstSize += Header::PackedLineByteCount(bitDepth, packing, runs[run]);
+		}
+		srcRows[row + 1] = srcRows[row] + srcSize;
+		dstRows[row + 1] = dstRows[row] + dstSize;
+	}
+
+	// the header keeps its fields but for the packing and the file size, the user data between
+	// the header and the image data is copied as it is
+	const long headerSize = sizeof(GenericHeader) + sizeof(IndustryHeader);
+	const long imageOffset = header.ImageOffset();
+	if (imageOffset < headerSize)
+		return false;
+
+	const bool srcSwap = header.RequiresByteSwap();
+	const bool dstSwap = (order != systemByteOrder);
+
+	Header dstHeader(header);
+	dstHeader.SetImagePacking(packing);
+	dstHeader.SetFileSize(U32(imageOffset + dstRows[rows] + eoimPad));
+	if (dstHeader.Write(out, dstSwap) == false)
+		return false;
+
+	bool status = true;
+	if (imageOffset > headerSize)
+	{
+		std::vector<unsigned char> user(imageOffset - headerSize);
+		status = (in->Read(&user[0], user.size()) == user.size() && out->Write(&user[0], user.size()) == user.size());
+	}
+
+	// a band of rows is read, repacked by the threads a row each and written out
+	std::vector<unsigned char> srcBand;
+	std::vector<unsigned char> dstBand;
+
+	for (int first = 0; status && first < rows; first += REPACK_BAND_LINES)
+	{
+		const int last = std::min(first + REPACK_BAND_LINES, rows);
+		const long srcSize = srcRows[last] - srcRows[first];
+		const long dstSize = dstRows[last] - dstRows[first];
+
+		srcBand.resize(srcSize);
+		dstBand.assign(dstSize, 0);
+		if (in->Read(&srcBand[0], srcSize) != size_t(srcSize))
+		{
+			status = false;
+			break;
+		}
+
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(static)
+#endif
+		for (int row = first; row < last; row++)
+		{
+			unsigned char *src = &srcBand[0] + (srcRows[row] - srcRows[first]);
+			unsigned char *dst = &dstBand[0] + (dstRows[row] - dstRows[first]);
+
+			for (int run = rowRuns[row]; run < rowRuns[row + 1]; run++)
+			{
+				const long srcRunSize = Header::PackedLineByteCount(bitDepth, srcPacking, runs[run]);
+				const long dstRunSize = Header::PackedLineByteCount(bitDepth, packing, runs[run]);
+
+				if (srcSwap)
+					SwapRun(src, srcRunSize, srcLayout);
+				RepackRun(src, srcLayout, dst, dstLayout, runs[run]);
+				if (dstSwap)
+					SwapRun(dst, dstRunSize, dstLayout);
+
+				src += srcRunSize;
+				dst += dstRunSize;
+			}
+		}
+
+		status = (out->Write(&dstBand[0], dstSize) == size_t(dstSize));
+	}
+
+	// end of image padding
+	if (status && eoimPad)
+	{
+		std::vector<unsigned char> blank(eoimPad, 0);
+		status = (out->Write(&blank[0], eoimPad) == eoimPad);
+	}
+
+	return status;
+}
+
+
+
+// the SMPTE DPX header: file information at 0, image information at 768, orientation at 1408,
+// film at 1664 and television at 1920; numbers left undefined are all ones, strings are zeros
+
+#define DPX_HEADER_SIZE					2048
+#define DPX_MAGIC_COOKIE				0x53445058
+
+
+static void PutU8(unsigned char *dpx, const int offset, const cineon::U8 value)
+{
+	dpx[offset] = value;
+}
+
+
+static void PutU16(unsigned char *dpx, const int offset, cineon::U16 value, const bool swap)
+{
+	if (swap)
+		cineon::SwapBytes(value);
+	::memcpy(dpx + offset, &value, sizeof(value));
+}
+
+
+static void PutU32(unsigned char *dpx, const int offset, cineon::U32 value, const bool swap)
+{
+	if (swap)
+		cineon::SwapBytes(value);
+	::memcpy(dpx + offset, &value, sizeof(value));
+}
+
+
+static void PutR32(unsigned char *dpx, const int offset, cineon::R32 value, const bool swap)
+{
+	cineon::U32 bits;
+	::memcpy(&bits, &value, sizeof(bits));
+	PutU32(dpx, offset, bits, swap);
+}
+
+
+// copies up to the end of the shorter field or the first zero
+static void PutString(unsigned char *dpx, const int offset, const int size, const char *str, const int length)
+{
+	::memset(dpx + offset, 0, size);
+	for (int i = 0; i < std::min(size, length) && str[i]; i++)
+		dpx[offset + i] = str[i];
+}
+
+
+// Cineon leaves a float undefined as infinity or as the value of all ones cast to a float
+static bool DefinedFloat(const cineon::R32 value)
+{
+	return (value == value && value > -4.0e9f && value < 4.0e9f);
+}
+
+
+// the DPX packing of the image data of a Cineon file that DPX holds as it is, 0 if there is none
+static int DpxPacking(const cineon::Header &header)
+{
+	const int numberOfComponents = header.NumberOfElements();
+	if (numberOfComponents < 1 || numberOfComponents > 8 || header.ConsistentBitDepth() == false ||
+			header.ConsistentSize() == false || header.BitDepth(0) != 10 || header.DataSign() == 1)
+		return 0;
+
+	// a single element holds all the components one pixel after the other
+	const cineon::Interleave interleave = header.ImageInterleave();
+	if (numberOfComponents > 1 && (interleave == cineon::kLine || interleave == cineon::kChannel))
+		return 0;
+
+	switch (header.ImagePacking() & ~cineon::kPackAsManyAsPossible)
+	{
+	case cineon::kLongWordLeft:
+		return 1;
+	case cineon::kLongWordRight:
+		return 2;
+	}
+
+	return 0;
+}
+
+
+// DPX descriptor, transfer characteristic and colorimetric specification of the components
+static void DpxDescriptor(const cineon::Header &header, int &descriptor, int &transfer)
+{
+	const int numberOfComponents = header.NumberOfElements();
+	const cineon::Descriptor first = header.ImageDescriptor(0);
+
+	// printing density unless the elements are Rec. 709 video
+	transfer = (first >= cineon::kRec709Red && first <= cineon::kRec709Blue ? 6 : 1);
+
+	if (numberOfComponents == 1)
+	{
+		switch (first)
+		{
+		case cineon::kPrintingDensityRed:
+		case cineon::kRec709Red:
+			descriptor = 1;
+			break;
+		case cineon::kPrintingDensityGreen:
+		case cineon::kRec709Green:
+			descriptor = 2;
+			break;
+		case cineon::kPrintingDensityBlue:
+		case cineon::kRec709Blue:
+			descriptor = 3;
+			break;
+		default:
+			descriptor = 6;
+		}
+	}
+	else if (numberOfComponents == 3)
+		descriptor = 50;
+	else if (numberOfComponents == 4)
+		descriptor = 51;
+	else
+		descriptor = 148 + numberOfComponents;
+}
+
+
+// fills the DPX header of the image data of the Cineon file, written at the DPX image offset
+static void BuildDpxHeader(const cineon::Header &header, const int packing, const cineon::U32 imageSize,
+						   const cineon::U32 eolnPad, const bool swap, unsigned char *dpx)
+{
+	using namespace cineon;
+
+	::memset(dpx, 0xff, DPX_HEADER_SIZE);
+	char str[40];
+
+	// file information
+	PutU32(dpx, 0, DPX_MAGIC_COOKIE, swap);
+	PutU32(dpx, 4, DPX_HEADER_SIZE, swap);
+	PutString(dpx, 8, 8, "V2.0", 4);
+	PutU32(dpx, 16, DPX_HEADER_SIZE + imageSize, swap);
+	PutU32(dpx, 20, 1, swap);
+	PutU32(dpx, 24, 1664, swap);
+	PutU32(dpx, 28, 384, swap);
+	PutU32(dpx, 32, 0, swap);
+	PutString(dpx, 36, 100, header.fileName, sizeof(header.fileName));
+
+	// yyyy:mm:dd:hh:mm:ssLTZ
+	char creation[24];
+	PutString(reinterpret_cast<unsigned char *>(creation), 0, 24, header.creationDate, sizeof(header.creationDate));
+	const int dateLength = int(::strlen(creation));
+	if (dateLength && dateLength < 23 && header.creationTime[0])
+	{
+		creation[dateLength] = ':';
+		PutString(reinterpret_cast<unsigned char *>(creation), dateLength + 1, 23 - dateLength, header.creationTime, sizeof(header.creationTime));
+	}
+	PutString(dpx, 136, 24, creation, 24);
+
+	::sprintf(str, "libcineon %s", LibraryVersion());
+	PutString(dpx, 160, 100, str, 100);
+	PutString(dpx, 260, 200, "", 0);
+	PutString(dpx, 460, 200, "", 0);
+	PutString(dpx, 664, 104, "", 0);
+
+	// image information, a single element
+	int descriptor, transfer;
+	DpxDescriptor(header, descriptor, transfer);
+
+	PutU16(dpx, 768, header.ImageOrientation() == kUndefinedOrientation ? 0 : U16(header.ImageOrientation()), swap);
+	PutU16(dpx, 770, 1, swap);
+	PutU32(dpx, 772, header.StoredWidth(), swap);
+	PutU32(dpx, 776, header.StoredHeight(), swap);
+
+	PutU32(dpx, 780, 0, swap);
+	if (DefinedFloat(header.LowData(0)) && header.LowData(0) >= 0.0f)
+		PutU32(dpx, 784, U32(header.LowData(0) + 0.5f), swap);
+	if (DefinedFloat(header.LowQuantity(0)))
+		PutR32(dpx, 788, header.LowQuantity(0), swap);
+	if (DefinedFloat(header.HighData(0)) && header.HighData(0) >= 0.0f)
+		PutU32(dpx, 792, U32(header.HighData(0) + 0.5f), swap);
+	if (DefinedFloat(header.HighQuantity(0)))
+		PutR32(dpx, 796, header.HighQuantity(0), swap);
+	PutU8(dpx, 800, U8(descriptor));
+	PutU8(dpx, 801, U8(transfer));
+	PutU8(dpx, 802, U8(transfer));
+	PutU8(dpx, 803, 10);
+	PutU16(dpx, 804, U16(packing), swap);
+	PutU16(dpx, 806, 0, swap);
+	PutU32(dpx, 808, DPX_HEADER_SIZE, swap);
+	PutU32(dpx, 812, eolnPad, swap);
+	PutU32(dpx, 816, 0, swap);
+	PutString(dpx, 820, 32, "", 0);
+	PutString(dpx, 1356, 52, "", 0);
+
+	// orientation
+	PutU32(dpx, 1408, U32(header.XOffset()), swap);
+	PutU32(dpx, 1412, U32(header.YOffset()), swap);
+	PutU32(dpx, 1424, header.StoredWidth(), swap);
+	PutU32(dpx, 1428, header.StoredHeight(), swap);
+	PutString(dpx, 1432, 100, header.sourceImageFileName, sizeof(header.sourceImageFileName));
+
+	char source[24];
+	PutString(reinterpret_cast<unsigned char *>(source), 0, 24, header.sourceDate, sizeof(header.sourceDate));
+	const int sourceLength = int(::strlen(source));
+	if (sourceLength && sourceLength < 23 && header.sourceTime[0])
+	{
+		source[sourceLength] = ':';
+		PutString(reinterpret_cast<unsigned char *>(source), sourceLength + 1, 23 - sourceLength, header.sourceTime, sizeof(header.sourceTime));
+	}
+	PutString(dpx, 1532, 24, source, 24);
+	PutString(dpx, 1556, 32, header.inputDevice, sizeof(header.inputDevice));
+	PutString(dpx, 1588, 32, header.inputDeviceSerialNumber, sizeof(header.inputDeviceSerialNumber));
+
+	// the scanned size in millimetres follows from the pitch in samples per millimetre
+	if (DefinedFloat(header.XDevicePitch()) && header.XDevicePitch() > 0.0f)
+		PutR32(dpx, 1636, header.StoredWidth() / header.XDevicePitch(), swap);
+	if (DefinedFloat(header.YDevicePitch()) && header.YDevicePitch() > 0.0f)
+		PutR32(dpx, 1640, header.StoredHeight() / header.YDevicePitch(), swap);
+	PutString(dpx, 1644, 20, "", 0);
+
+	// film, the edge code numbers become digits
+	PutString(dpx, 1664, 48, "", 0);
+	if (header.filmManufacturingIdCode != 0xff)
+	{
+		::sprintf(str, "%02u", unsigned(header.filmManufacturingIdCode % 100));
+		PutString(dpx, 1664, 2, str, 2);
+	}
+	if (header.filmType != 0xff)
+	{
+		::sprintf(str, "%02u", unsigned(header.filmType % 100));
+		PutString(dpx, 1666, 2, str, 2);
+	}
+	if (header.perfsOffset != 0xff)
+	{
+		::sprintf(str, "%02u", unsigned(header.perfsOffset % 100));
+		PutString(dpx, 1668, 2, str, 2);
+	}
+	if (header.prefix != 0xffffffff)
+	{
+		::sprintf(str, "%06u", unsigned(header.prefix % 1000000));
+		PutString(dpx, 1670, 6, str, 6);
+	}
+	if (header.count != 0xffffffff)
+	{
+		::sprintf(str, "%04u", unsigned(header.count % 10000));
+		PutString(dpx, 1676, 4, str, 4);
+	}
+	PutString(dpx, 1680, 32, header.format, sizeof(header.format));
+	PutU32(dpx, 1712, header.FramePosition(), swap);
+	if (DefinedFloat(header.FrameRate()))
+		PutR32(dpx, 1724, header.FrameRate(), swap);
+	PutString(dpx, 1732, 32, header.frameId, sizeof(header.frameId));
+	PutString(dpx, 1764, 100, header.slateInfo, sizeof(header.slateInfo));
+	PutString(dpx, 1864, 56, "", 0);
+
+	// television
+	if (DefinedFloat(header.Gamma()))
+		PutR32(dpx, 1948, header.Gamma(), swap);
+	PutString(dpx, 1972, 76, "", 0);
+}
+
+
+// reads the header and lays out the DPX file, the source being positioned at its image data
+static bool DpxLayout(InStream *in, cineon::Header &header, int &packing, cineon::U32 &imageSize, cineon::U32 &eolnPad, cineon::U32 &lineSize)
+{
+	using namespace cineon;
+
+	if (header.Read(in) == false)
+		return false;
+
+	packing = DpxPacking(header);
+	if (packing == 0)
+		return false;
+
+	eolnPad = header.EndOfLinePadding();
+	if (eolnPad == ~U32(0))
+		eolnPad = 0;
+
+	lineSize = Header::PackedLineByteCount(10, header.ImagePacking(), header.StoredWidth() * header.NumberOfElements());
+	imageSize = (lineSize + eolnPad) * header.StoredHeight();
+
+	return in->Seek(header.ImageOffset(), InStream::kStart);
+}
+
+
+bool cineon::ConvertToDpx(InStream *in, OutStream *out, const Endian order)
+{
+	Header header;
+	int packing;
+	U32 imageSize, eolnPad, lineSize;
+	if (DpxLayout(in, header, packing, imageSize, eolnPad, lineSize) == false)
+		return false;
+
+	// the words of the source only need their bytes swapped when the two orders differ
+	const bool srcSwap = header.RequiresByteSwap();
+	const bool dstSwap = (order != systemByteOrder);
+
+	unsigned char dpx[DPX_HEADER_SIZE];
+	BuildDpxHeader(header, packing, imageSize, eolnPad, dstSwap, dpx);
+	if (out->Write(dpx, DPX_HEADER_SIZE) != DPX_HEADER_SIZE)
+		return false;
+
+	// a band of lines at a time, the end of line padding kept as it is
+	const int rowSize = lineSize + eolnPad;
+	const int rows = header.StoredHeight();
+	std::vector<unsigned char> band;
+
+	for (int first = 0; first < rows; first += REPACK_BAND_LINES)
+	{
+		const int count = std::min(REPACK_BAND_LINES, rows - first);
+		const size_t size = size_t(count) * rowSize;
+
+		band.resize(size);
+		if (in->Read(&band[0], size) != size)
+			return false;
+
+		if (srcSwap != dstSwap)
+		{
+#ifdef _OPENMP
+			#pragma omp parallel for schedule(static)
+#endif
+			for (int row = 0; row < count; row++)
+				SwapBuffer(reinterpret_cast<U32 *>(&band[0] + size_t(row) * rowSize), lineSize / sizeof(U32));
+		}
+
+		if (out->Write(&band[0], size) != size)
+			return false;
+	}
+
+	return true;
+}
+
+
+// copies size bytes between the two files by the kernel where it can, through a buffer otherwise
+#ifndef WIN32
+static bool CopyFileRange(const int inFd, const long inOffset, const int outFd, const long outOffset, const size_t size)
+{
+	off_t inPos = inOffset;
+	off_t outPos = outOffset;
+	size_t remaining = size;
+
+#if defined(HAVE_COPY_FILE_RANGE) && defined(__linux__)
+	// file systems or kernels that cannot do it fail on the first call and leave the rest to be copied below
+	while (remaining)
+	{
+		loff_t i = inPos, o = outPos;
+		const ssize_t n = ::copy_file_range(inFd, &i, outFd, &o, remaining, 0);
+		if (n <= 0)
+			break;
+		inPos += n;
+		outPos += n;
+		remaining -= n;
+	}
+#endif
+
+#if defined(HAVE_SENDFILE) && defined(__linux__)
+	if (remaining && ::lseek(outFd, outPos, SEEK_SET) == outPos)
+	{
+		while (remaining)
+		{
+			const ssize_t n = ::sendfile(outFd, inFd, &inPos, remaining);
+			if (n <= 0)
+				break;
+			outPos += n;
+			remaining -= n;
+		}
+	}
+#endif
+
+	std::vector<char> buf(std::min(remaining, size_t(1 << 20)));
+	while (remaining)
+	{
+		const ssize_t r = ::pread(inFd, &buf[0], std::min(remaining, buf.size()), inPos);
+		if (r <= 0)
+			return false;
+
+		for (ssize_t w = 0; w < r; )
+		{
+			const ssize_t n = ::pwrite(outFd, &buf[0] + w, r - w, outPos + w);
+			if (n <= 0)
+				return false;
+			w += n;
+		}
+
+		inPos += r;
+		outPos += r;
+		remaining -= r;
+	}
+
+	return true;
+}
+#endif
+
+
+bool cineon::ConvertToDpx(const char *inFileName, const char *outFileName, const Endian order)
+{
+	InStream in;
+	if (in.Open(inFileName) == false)
+		return false;
+
+	Header header;
+	int packing;
+	U32 imageSize, eolnPad, lineSize;
+	if (DpxLayout(&in, header, packing, imageSize, eolnPad, lineSize) == false)
+		return false;
+
+	const bool srcSwap = header.RequiresByteSwap();
+	const bool dstSwap = (order != systemByteOrder);
+
+#ifndef WIN32
+	// the image data moves between the files untouched when the byte order is kept
+	if (srcSwap == dstSwap)
+	{
+		in.Close();
+
+		unsigned char dpx[DPX_HEADER_SIZE];
+		BuildDpxHeader(header, packing, imageSize, eolnPad, dstSwap, dpx);
+
+		const int inFd = ::open(inFileName, O_RDONLY);
+		if (inFd < 0)
+			return false;
+		const int outFd = ::open(outFileName, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (outFd < 0)
+		{
+			::close(inFd);
+			return false;
+		}
+
+		bool status = (::pwrite(outFd, dpx, DPX_HEADER_SIZE, 0) == DPX_HEADER_SIZE &&
+				CopyFileRange(inFd, header.ImageOffset(), outFd, DPX_HEADER_SIZE, imageSize));
+
+		::close(inFd);
+		if (::close(outFd) != 0)
+			status = false;
+		return status;
+	}
+#endif
+
+	OutStream out;
+	if (out.Open(outFileName) == false)
+		return false;
+
+	const bool status = ConvertToDpx(&in, &out, order);
+	out.Close();
+	return status;
+}
@@ -0,0 +1,368 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick A. Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick A. Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef _CINEON_TRANSCODERINTERNAL_H
+#define _CINEON_TRANSCODERINTERNAL_H 1
+
+
+#include "EndianSwap.h"
+
+
+// number of lines repacked together, a thread repacks the lines of a band it is given
+#define REPACK_BAND_LINES				64
+
+
+namespace cineon
+{
+
+	// how the code values of a run of components are laid out, a run starting with a new word or cell
+	struct RunLayout
+	{
+		enum Kind
+		{
+			kBitstream,									// packed one after the other from the least significant bit of U32 words
+			kByteCells,									// cells of a byte
+			kTwoByteCells,								// cells of two bytes, the first one most significant
+			kWordCells,									// cells of a U16
+			kLongWordCells,								// cells of a U32
+			kBytes,										// a U8 each
+			kWords										// a U16 each, in the most significant bits
+		};
+
+		Kind kind;
+		int bitDepth;
+		int perCell;									// components in a cell
+		int top;										// shift of the first component of a cell
+
+		// the layout of components of bitDepth bits packed with packing, false if it has none
+		bool Set(const int bitDepth, const Packing packing)
+		{
+			this->bitDepth = bitDepth;
+			this->perCell = 1;
+			this->top = 0;
+
+			const int bits = Header::PackingCellBits(bitDepth, packing);
+			if (bits)
+			{
+				const int method = (packing & ~kPackAsManyAsPossible);
+				const bool left = (method == kByteLeft || method == kWordLeft || method == kLongWordLeft);
+
+				this->perCell = Header::PackingCellComponents(bitDepth, packing);
+				this->top = (left ? bits : this->perCell * bitDepth) - bitDepth;
+
+				if (method == kByteLeft || method == kByteRight)
+					this->kind = (bits == 8 ? kByteCells : kTwoByteCells);
+				else if (method == kWordLeft || method == kWordRight)
+					this->kind = kWordCells;
+				else
+					this->kind = kLongWordCells;
+			}
+			else if (packing == kPacked && bitDepth != 8 && bitDepth < 16)
+				this->kind = kBitstream;
+			else if (bitDepth == 8)
+				this->kind = kBytes;
+			else if (bitDepth > 8 && bitDepth <= 16)
+				this->kind = kWords;
+			else
+				return false;
+
+			return true;
+		}
+
+		// bytes swapped together when the byte order changes
+		int SwapBytes() const
+		{
+			if (this->kind == kBitstream || this->kind == kLongWordCells)
+				return 4;
+			if (this->kind == kWordCells || this->kind == kWords)
+				return 2;
+			return 1;
+		}
+	};
+
+
+	// sources hand out the code values of a run one after the other, sinks take them and put them
+	// in place, so that a run is repacked in one pass with the code values held in registers
+
+	struct BitstreamSource
+	{
+		const U32 *words;
+		U64 bits;
+		int held;
+		int depth;
+		U32 mask;
+
+		BitstreamSource(const void *buf, const RunLayout &layout) : words(reinterpret_cast<const U32 *>(buf)), bits(0), held(0),
+				depth(layout.bitDepth), mask((U32(1) << layout.bitDepth) - 1) { }
+
+		U32 Next()
+		{
+			if (this->held < this->depth)
+			{
+				this->bits |= U64(*this->words++) << this->held;
+				this->held += 32;
+			}
+			const U32 value = U32(this->bits) & this->mask;
+			this->bits >>= this->depth;
+			this->held -= this->depth;
+			return value;
+		}
+	};
+
+
+	template <typename CELL, int CELLS>
+	struct CellSource
+	{
+		const CELL *cells;
+		U32 cell;
+		int shift;
+		int left;
+		int perCell;
+		int top;
+		int depth;
+		U32 mask;
+
+		CellSource(const void *buf, const RunLayout &layout) : cells(reinterpret_cast<const CELL *>(buf)), cell(0), shift(0), left(0),
+				perCell(layout.perCell), top(layout.top), depth(layout.bitDepth), mask((U32(1) << layout.bitDepth) - 1) { }
+
+		U32 Next()
+		{
+			if (this->left == 0)
+			{
+				this->cell = (CELLS == 1 ? U32(this->cells[0]) : (U32(this->cells[0]) << 8 | this->cells[1]));
+				this->cells += CELLS;
+				this->shift = this->top;
+				this->left = this->perCell;
+			}
+			const U32 value = this->cell >> this->shift & this->mask;
+			this->shift -= this->depth;
+			this->left--;
+			return value;
+		}
+	};
+
+
+	template <typename T>
+	struct PlainSource
+	{
+		const T *p;
+		int shift;
+
+		PlainSource(const void *buf, const RunLayout &layout) : p(reinterpret_cast<const T *>(buf)), shift(int(sizeof(T)) * 8 - layout.bitDepth) { }
+
+		U32 Next()
+		{
+			return U32(*this->p++) >> this->shift;
+		}
+	};
+
+
+	struct BitstreamSink
+	{
+		U32 *words;
+		U64 bits;
+		int used;
+		int depth;
+
+		BitstreamSink(void *buf, const RunLayout &layout) : words(reinterpret_cast<U32 *>(buf)), bits(0), used(0), depth(layout.bitDepth) { }
+
+		void Put(const U32 value)
+		{
+			this->bits |= U64(value) << this->used;
+			this->used += this->depth;
+			if (this->used >= 32)
+			{
+				*this->words++ = U32(this->bits);
+				this->bits >>= 32;
+				this->used -= 32;
+			}
+		}
+
+		void Flush()
+		{
+			if (this->used)
+				*this->words++ = U32(this->bits);
+		}
+	};
+
+
+	template <typename CELL, int CELLS>
+	struct CellSink
+	{
+		CELL *cells;
+		U32 cell;
+		int shift;
+		int held;
+		int perCell;
+		int top;
+		int depth;
+
+		CellSink(void *buf, const RunLayout &layout) : cells(reinterpret_cast<CELL *>(buf)), cell(0), shift(layout.top), held(0),
+				perCell(layout.perCell), top(layout.top), depth(layout.bitDepth) { }
+
+		void Put(const U32 value)
+		{
+			this->cell |= value << this->shift;
+			this->shift -= this->depth;
+			if (++this->held == this->perCell)
+				this->Store();
+		}
+
+		void Flush()
+		{
+			if (this->held)
+				this->Store();
+		}
+
+		void Store()
+		{
+			if (CELLS == 1)
+				this->cells[0] = CELL(this->cell);
+			else
+			{
+				this->cells[0] = CELL(this->cell >> 8);
+				this->cells[1] = CELL(this->cell);
+			}
+			this->cells += CELLS;
+			this->cell = 0;
+			this->shift = this->top;
+			this->held = 0;
+		}
+	};
+
+
+	template <typename T>
+	struct PlainSink
+	{
+		T *p;
+		int shift;
+
+		PlainSink(void *buf, const RunLayout &layout) : p(reinterpret_cast<T *>(buf)), shift(int(sizeof(T)) * 8 - layout.bitDepth) { }
+
+		void Put(const U32 value)
+		{
+			*this->p++ = T(value << this->shift);
+		}
+
+		void Flush()
+		{
+		}
+	};
+
+
+	template <typename SRC, typename DST>
+	void RepackRun(SRC src, DST dst, const int count)
+	{
+		for (int i = 0; i < count; i++)
+			dst.Put(src.Next());
+		dst.Flush();
+	}
+
+
+	template <typename SRC>
+	void RepackRun(const SRC &src, void *dst, const RunLayout &layout, const int count)
+	{
+		switch (layout.kind)
+		{
+		case RunLayout::kBitstream:
+			RepackRun(src, BitstreamSink(dst, layout), count);
+			break;
+		case RunLayout::kByteCells:
+			RepackRun(src, CellSink<U8, 1>(dst, layout), count);
+			break;
+		case RunLayout::kTwoByteCells:
+			RepackRun(src, CellSink<U8, 2>(dst, layout), count);
+			break;
+		case RunLayout::kWordCells:
+			RepackRun(src, CellSink<U16, 1>(dst, layout), count);
+			break;
+		case RunLayout::kLongWordCells:
+			RepackRun(src, CellSink<U32, 1>(dst, layout), count);
+			break;
+		case RunLayout::kBytes:
+			RepackRun(src, PlainSink<U8>(dst, layout), count);
+			break;
+		case RunLayout::kWords:
+			RepackRun(src, PlainSink<U16>(dst, layout), count);
+			break;
+		}
+	}
+
+
+	// repack a run of count components from the layout of src to the layout of dst
+	inline void RepackRun(const void *src, const RunLayout &srcLayout, void *dst, const RunLayout &dstLayout, const int count)
+	{
+		switch (srcLayout.kind)
+		{
+		case RunLayout::kBitstream:
+			RepackRun(BitstreamSource(src, srcLayout), dst, dstLayout, count);
+			break;
+		case RunLayout::kByteCells:
+			RepackRun(CellSource<U8, 1>(src, srcLayout), dst, dstLayout, count);
+			break;
+		case RunLayout::kTwoByteCells:
+			RepackRun(CellSource<U8, 2>(src, srcLayout), dst, dstLayout, count);
+			break;
+		case RunLayout::kWordCells:
+			RepackRun(CellSource<U16, 1>(src, srcLayout), dst, dstLayout, count);
+			break;
+		case RunLayout::kLongWordCells:
+			RepackRun(CellSource<U32, 1>(src, srcLayout), dst, dstLayout, count);
+			break;
+		case RunLayout::kBytes:
+			RepackRun(PlainSource<U8>(src, srcLayout), dst, dstLayout, count);
+			break;
+		case RunLayout::kWords:
+			RepackRun(PlainSource<U16>(src, srcLayout), dst, dstLayout, count);
+			break;
+		}
+	}
+
+
+	// swap the bytes of a run laid out as layout says
+	inline void SwapRun(void *buf, const long bytes, const RunLayout &layout)
+	{
+		if (layout.SwapBytes() == 4)
+			EndianSwapImageBuffer<kInt>(buf, int(bytes / sizeof(U32)));
+		else if (layout.SwapBytes() == 2)
+			EndianSwapImageBuffer<kWord>(buf, int(bytes / sizeof(U16)));
+	}
+
+}
+
+#endif
+
+
@@ -34,21 +34,28 @@
 
 #include <cstring>
 #include <ctime>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "Cineon.h"
 #include "CineonStream.h"
 #include "EndianSwap.h"
 #include "WriterInternal.h"
+#include "PrintingDensity.h"
 
 
 
-cineon::Writer::Writer() : fileLoc(0)
+cineon::Writer::Writer() : fileLoc(0), fd(0), threads(1), encoding(0), scanElement(-1), scanBuffer(0), scanBufferSize(0), scanBlank(0)
 {
 }
 
 
 cineon::Writer::~Writer()
 {
+	delete this->encoding;
+	delete [] this->scanBuffer;
+	delete [] this->scanBlank;
 }
 
 
@@ -99,6 +106,53 @@ void cineon::Writer::SetOutStream(OutStream *fd)
 }
 
 
+void cineon::Writer::SetThreadCount(const int count)
+{
+	this->threads = count;
+}
+
+
+void cineon::Writer::SetWriteOptions(const WriteOptions &options)
+{
+	this->options = options;
+}
+
+
+// the encoding table is built once the header is complete, WriteBand() may then use it from several threads
+bool cineon::Writer::PrepareEncoding()
+{
+	delete this->encoding;
+	this->encoding = 0;
+
+	if (this->options.linearToLog == false)
+		return true;
+
+	const int bitDepth = this->header.BitDepth(0);
+	if (bitDepth > 16)
+		return false;
+
+	PrintingDensity conversion;
+	if (conversion.Set(this->header, 0, this->options.referenceBlack, this->options.referenceWhite, this->options.filmGamma) == false)
+		return false;
+
+	// one table encodes the components of every element, which have to share the code values
+	// of the first one
+	for (int i = 1; i < this->header.ImageElementCount(); i++)
+	{
+		PrintingDensity element;
+		if (this->header.BitDepth(i) != bitDepth ||
+			element.Set(this->header, i, this->options.referenceBlack, this->options.referenceWhite, this->options.filmGamma) == false ||
+			!(element == conversion))
+			return false;
+	}
+
+	// components are rounded to the code value whose half way points enclose them
+	this->encoding = new LogEncoding(conversion, bitDepth);
+
+	return true;
+}
+
+
 bool cineon::Writer::WriteHeader()
 {
 	// calculate any header info
@@ -111,6 +165,13 @@ bool cineon::Writer::WriteHeader()
 	// writing the header count
 	this->fileLoc = this->header.Size();
 
+	// the image follows the header and the user data unless placed elsewhere
+	if (this->header.ImageOffset() == 0xffffffff)
+		this->header.SetImageOffset(this->fileLoc + this->header.UserSize());
+
+	if (this->PrepareEncoding() == false)
+		return false;
+
 	return this->header.Write(fd);
 }
 
@@ -145,6 +206,8 @@ void cineon::Writer::SetElement(const int num, const Descriptor desc, const U8 b
 	this->header.SetHighQuantity(num, highQuantity);
 	this->header.SetImageDescriptor(num, desc);
 	this->header.SetBitDepth(num, bitDepth);
+	this->header.SetPixelsPerLine(num, pixelsPerLine);
+	this->header.SetLinesPerElement(num, linesPerElement);
 
 	// determine if increases element count
 	this->header.CalculateNumberOfElements();
@@ -221,24 +284,37 @@ bool cineon::Writer::WriteElement(const int element, void *data, const DataSize
 	if (width == 0 || height == 0)
 		return false;
 
+	// the colour matrix needs three components of a type it can convert
+	if (this->options.matrix && MatrixSupported(size, noc) == false)
+		return false;
+
 	//  sizeof a component in an image
 	const int bytes = (bitDepth + 7) / 8;
 
+	// number of threads converting and packing bands of lines
+	int threads = this->threads;
+#ifdef _OPENMP
+	if (threads <= 0)
+		threads = omp_get_max_threads();
+#else
+	threads = 1;
+#endif
+
 	// allocate memory for use to write blank space
 	char *blank = 0;
 	if (eolnPad || eoimPad)
 	{
 		int bsize = eolnPad > eoimPad ? eolnPad : eoimPad;
 		blank = new char[bsize];
-		memset(blank, bsize, sizeof(char));
+		memset(blank, 0, bsize);
 	}
 
 	// can we write the entire memory chunk at once without any additional processing
-	if ((bitDepth == 8 && size == cineon::kByte) ||
-		 (bitDepth == 12 && size == cineon::kWord /*&& packing == kFilledMethodA*/) ||
+	if (this->options.matrix == 0 && Header::PackingCellBits(bitDepth, packing) == 0 &&
+		((bitDepth == 8 && size == cineon::kByte) ||
 		 (bitDepth == 16 && size == cineon::kWord) ||
 		 (bitDepth == 32 && size == cineon::kInt) ||
-		 (bitDepth == 64 && size == cineon::kLongLong))
+		 (bitDepth == 64 && size == cineon::kLongLong)))
 	{
 		status = this->WriteThrough(data, width, height, noc, bytes, eolnPad, eoimPad, blank);
 		if (blank)
@@ -251,9 +327,9 @@ bool cineon::Writer::WriteElement(const int element, void *data, const DataSize
 		{
 		case 8:
 			if (size == cineon::kByte)
-				this->fileLoc += WriteBuffer<U8, 8, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U8, 8, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			else
-				this->fileLoc += WriteBuffer<U8, 8, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U8, 8, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			break;
 
 		case 10:
@@ -262,37 +338,37 @@ bool cineon::Writer::WriteElement(const int element, void *data, const DataSize
 				reverse = true;*/
 
 			if (size == cineon::kWord)
-				this->fileLoc += WriteBuffer<U16, 10, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U16, 10, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			else
-				this->fileLoc += WriteBuffer<U16, 10, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U16, 10, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			break;
 
 		case 12:
 			if (size == cineon::kWord)
-				this->fileLoc += WriteBuffer<U16, 12, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U16, 12, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			else
-				this->fileLoc += WriteBuffer<U16, 12, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U16, 12, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			break;
 
 		case 16:
 			if (size == cineon::kWord)
-				this->fileLoc += WriteBuffer<U16, 16, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U16, 16, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			else
-				this->fileLoc += WriteBuffer<U16, 16, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U16, 16, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			break;
 
 		case 32:
 			if (size == cineon::kInt)
-				this->fileLoc += WriteBuffer<U32, 32, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U32, 32, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			else
-				this->fileLoc += WriteBuffer<U32, 32, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<U32, 32, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			break;
 
 		case 64:
 			if (size == cineon::kLongLong)
-				this->fileLoc += WriteBuffer<R64, 64, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<R64, 64, true>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			else
-				this->fileLoc += WriteBuffer<R64, 64, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, status);
+				this->fileLoc += WriteImageBuffer<R64, 64, false>(this->fd, size, data, width, height, noc, packing, reverse, eolnPad, blank, this->encoding, this->options.matrix, threads, status);
 			break;
 		}
 	}
@@ -332,14 +408,14 @@ bool cineon::Writer::WriteThrough(void *data, const U32 width, const U32 height,
 		for (i = 0; i < height; i++)
 		{
 			// write one line
-			if (this->fd->Write(imageBuf+(width*bytes*i), bytes * width) == false)
+			if (this->fd->Write(imageBuf+(width*noc*bytes*i), bytes * width * noc) == false)
 			{
 				status = false;
 				break;
 			}
 
 			// write end of line padding
-			if (this->fd->Write(blank, eoimPad) == false)
+			if (this->fd->Write(blank, eolnPad) == false)
 			{
 				status = false;
 				break;
@@ -368,8 +444,199 @@ bool cineon::Writer::WriteThrough(void *data, const U32 width, const U32 height,
 
 
 
+// lines are written to their own place in the file, so any number of threads can write
+// bands of the image at the same time
+
+bool cineon::Writer::WriteBand(const int element, void *data, const DataSize size, const int firstLine, const int lineCount)
+{
+	// make sure the range is good
+	if (element < 0 || element >= MAX_ELEMENTS)
+		return false;
+
+	// make sure the entry is valid
+	if (this->header.ImageDescriptor(element) == kUndefinedDescriptor)
+		return false;
+
+	// the header has to place the image
+	if (this->header.ImageOffset() == 0xffffffff)
+		return false;
+
+	// image parameters
+	const U32 eolnPad = this->header.EndOfLinePadding();
+	const U8 bitDepth = this->header.BitDepth(element);
+	const U32 width = this->header.Width();
+	const U32 height = this->header.Height();
+	const int noc = this->header.ImageElementComponentCount(element);
+	const Packing packing = this->header.ImagePacking();
+
+	// check the band, just in case
+	if (width == 0 || firstLine < 0 || lineCount <= 0 || U32(firstLine + lineCount) > height)
+		return false;
+
+	// the colour matrix needs three components of a type it can convert
+	if (this->options.matrix && MatrixSupported(size, noc) == false)
+		return false;
+
+	// every line takes the same room in the file
+	const long lineSize = PackedLineSize(bitDepth, packing, width * noc) + eolnPad;
+	const long offset = this->header.ImageOffset() + firstLine * lineSize;
+
+	// padding
+	char *blank = 0;
+	if (eolnPad)
+	{
+		blank = new char[eolnPad];
+		memset(blank, 0, eolnPad);
+	}
+
+	// pack the band
+	unsigned char *band = new unsigned char[lineCount * lineSize];
+	const int bandSize = PackImageBand(bitDepth, size, data, width, 0, lineCount, noc, packing, false, eolnPad, blank, this->encoding, this->options.matrix, band);
+
+	bool status = (bandSize == lineCount * lineSize && this->fd->WriteAt(band, bandSize, offset) == size_t(bandSize));
+
+	delete [] band;
+	if (blank)
+		delete [] blank;
+
+	return status;
+}
+
+
+
+bool cineon::Writer::BeginScanlines(const int element, const DataSize size)
+{
+	// make sure the range is good
+	if (element < 0 || element >= MAX_ELEMENTS)
+		return false;
+
+	// make sure the entry is valid
+	if (this->header.ImageDescriptor(element) == kUndefinedDescriptor)
+		return false;
+
+	// check width & height, just in case
+	if (this->header.Width() == 0 || this->header.Height() == 0)
+		return false;
+
+	// the colour matrix needs three components of a type it can convert
+	if (this->options.matrix && MatrixSupported(size, this->header.ImageElementComponentCount(element)) == false)
+		return false;
+
+	// mark location in headers
+	if (element == 0)
+		this->header.SetImageOffset(this->fileLoc);
+
+	this->scanElement = element;
+	this->scanSize = size;
+	this->scanLine = 0;
+
+	// end of line padding
+	const U32 eolnPad = this->header.EndOfLinePadding();
+	delete [] this->scanBlank;
+	this->scanBlank = 0;
+	if (eolnPad)
+	{
+		this->scanBlank = new char[eolnPad];
+		memset(this->scanBlank, 0, eolnPad);
+	}
+
+	return true;
+}
+
+
+bool cineon::Writer::WriteScanlines(void *data, const int count)
+{
+	if (this->scanElement < 0)
+		return false;
+
+	// image parameters
+	const U32 eolnPad = this->header.EndOfLinePadding();
+	const U8 bitDepth = this->header.BitDepth(this->scanElement);
+	const U32 width = this->header.Width();
+	const int noc = this->header.ImageElementComponentCount(this->scanElement);
+	const Packing packing = this->header.ImagePacking();
+
+	// check the line count, just in case
+	if (count <= 0 || this->scanLine + count > this->header.Height())
+		return false;
+
+	// keep one buffer for the packed lines across the calls
+	const int lineSize = PackedLineSize(bitDepth, packing, width * noc) + eolnPad;
+	if (this->scanBufferSize < count * lineSize)
+	{
+		delete [] this->scanBuffer;
+		this->scanBufferSize = count * lineSize;
+		this->scanBuffer = new unsigned char[this->scanBufferSize];
+	}
+
+	const int size = PackImageBand(bitDepth, this->scanSize, data, width, 0, count, noc, packing, false, eolnPad, this->scanBlank, this->encoding, this->options.matrix, this->scanBuffer);
+	if (size != count * lineSize)
+		return false;
+
+	this->scanLine += count;
+	this->fileLoc += size;
+
+	return (this->fd->Write(this->scanBuffer, size) == size_t(size));
+}
+
+
+bool cineon::Writer::EndScanlines()
+{
+	if (this->scanElement < 0)
+		return false;
+
+	bool status = (this->scanLine == this->header.Height());
+
+	// end of image padding
+	const U32 eoimPad = this->header.EndOfImagePadding();
+	if (status && eoimPad)
+	{
+		char *blank = new char[eoimPad];
+		memset(blank, 0, eoimPad);
+		this->fileLoc += eoimPad;
+		status = (this->fd->Write(blank, eoimPad) == eoimPad);
+		delete [] blank;
+	}
+
+	// release the line buffers
+	delete [] this->scanBuffer;
+	delete [] this->scanBlank;
+	this->scanBuffer = 0;
+	this->scanBufferSize = 0;
+	this->scanBlank = 0;
+	this->scanElement = -1;
+
+	return status;
+}
+
+
+
 bool cineon::Writer::Finish()
 {
+	// bands written in place do not advance the file location, so account for the whole image
+	if (this->header.ImageOffset() != 0xffffffff && this->header.ImageDescriptor(0) != kUndefinedDescriptor)
+	{
+		const U32 eoimPad = this->header.EndOfImagePadding();
+		const long imageEnd = this->header.ImageOffset() + long(this->header.Height()) *
+				(PackedLineSize(this->header.BitDepth(0), this->header.ImagePacking(), this->header.Width() * this->header.ImageElementComponentCount(0)) +
+				 this->header.EndOfLinePadding()) + eoimPad;
+
+		if (this->fileLoc < imageEnd)
+		{
+			// end of image padding
+			if (eoimPad)
+			{
+				char *blank = new char[eoimPad];
+				memset(blank, 0, eoimPad);
+				bool status = (this->fd->WriteAt(blank, eoimPad, imageEnd - eoimPad) == eoimPad);
+				delete [] blank;
+				if (!status)
+					return false;
+			}
+			this->fileLoc = imageEnd;
+		}
+	}
+
 	// write the file size in the header
 	this->header.SetFileSize(this->fileLoc);
 
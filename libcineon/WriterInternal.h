@@ -37,7 +37,20 @@
 #define _CINEON_WRITERINTERNAL_H 1
 
 
+#include <algorithm>
+#include <cstring>
+
 #include "BaseTypeConverter.h"
+#include "ColorMatrix.h"
+#include "PrintingDensity.h"
+
+
+// number of lines converted and packed together by a thread in band encoding
+#define BAND_LINES						32
+
+// number of components encoded as printing density together before they are packed, whole
+// groups of the three components of a 10-bit longword
+#define ENCODE_CHUNK					192
 
 
 namespace cineon
@@ -64,6 +77,10 @@ namespace cineon
 			MultiTypeBufferCopy<IB, U32>(dst, reinterpret_cast<U32 *>(src), len);
 		else if (src_size == kLongLong)
 			MultiTypeBufferCopy<IB, U64>(dst, reinterpret_cast<U64 *>(src), len);
+		else if (src_size == kFloat)
+			MultiTypeBufferCopy<IB, R32>(dst, reinterpret_cast<R32 *>(src), len);
+		else if (src_size == kHalf)
+			MultiTypeBufferCopy<IB, R16>(dst, reinterpret_cast<R16 *>(src), len);
 
 	}
 
@@ -173,6 +190,10 @@ namespace cineon
 			}
 		}
 
+		// clear the unused bits of the last word, the buffer may hold anything there
+		if ((len * BITDEPTH) % 32)
+			dst_u32[(len * BITDEPTH) / 32] &= (U32(1) << ((len * BITDEPTH) % 32)) - 1;
+
 		// adjust offset/length
 		access.offset = 0;
 		access.length = (((len * BITDEPTH) / 32) + ((len * BITDEPTH) % 32 ? 1 : 0)) * 2;
@@ -192,8 +213,8 @@ namespace cineon
 		const U32 bitdepth = 10;
 		const U32 bitmask = 0x03ff;
 
-		// shift bits over 2 if Method A
-		const int method_shift = 0;//(METHOD == kFilledMethodA ? 2 : 0);
+		// shift bits over 2 if left justified
+		const int method_shift = (METHOD == kLongWordLeft ? 2 : 0);
 
 		// loop through the buffer
 		int i;
@@ -210,8 +231,8 @@ namespace cineon
 				value = 0;
 			}
 
-			// if reverse the order
-			if (reverse)
+			// the first component goes to the most significant bits unless reversed
+			if (!reverse)
 				rem = 2 - rem;
 
 			// place the 10 bits in the proper place with mask
@@ -233,76 +254,301 @@ namespace cineon
 
 
 
+	// pack components into cells of a byte, a word or a longword as the packing describes them, the
+	// first component of a cell in its most significant bits, src may be dst, the cells are filled
+	// from the last one back when they take more room than the components they hold
+	template <typename IB, int BITDEPTH>
+	void WritePackedCells(IB *src, IB *dst, const int len, const Packing packing, BufferAccess &access)
+	{
+		const int bits = Header::PackingCellBits(BITDEPTH, packing);
+		const int perCell = Header::PackingCellComponents(BITDEPTH, packing);
+		const int method = (packing & ~kPackAsManyAsPossible);
+		const bool left = (method == kByteLeft || method == kWordLeft || method == kLongWordLeft);
+
+		// components arrive in the most significant bits of IB, cells only hold bit depths up to
+		// 16 but the 32 and 64-bit instantiations need a mask that does not overflow the shift
+		const int shift = int(sizeof(IB)) * 8 - BITDEPTH;
+		const U32 mask = ~U32(0) >> ((32 - BITDEPTH) & 31);
+
+		// shift of the first component of a cell, the others follow BITDEPTH bits further down
+		const int top = (left ? bits : perCell * BITDEPTH) - BITDEPTH;
+
+		U8 *dst_u8 = reinterpret_cast<U8 *>(dst);
+		U16 *dst_u16 = reinterpret_cast<U16 *>(dst);
+		U32 *dst_u32 = reinterpret_cast<U32 *>(dst);
+
+		const int cells = (len + perCell - 1) / perCell;
+		const bool grows = (bits / perCell >= int(sizeof(IB)) * 8);
+		for (int n = 0; n < cells; n++)
+		{
+			const int c = (grows ? cells - 1 - n : n);
+			U32 value = 0;
+			for (int j = 0; j < perCell && c * perCell + j < len; j++)
+				value |= ((static_cast<U32>(src[c * perCell + j + access.offset]) >> shift) & mask) << (top - j * BITDEPTH);
+
+			if (method == kByteLeft || method == kByteRight)
+			{
+				// components wider than a byte take two cells
+				if (bits == 16)
+				{
+					dst_u8[c * 2] = U8(value >> 8);
+					dst_u8[c * 2 + 1] = U8(value);
+				}
+				else
+					dst_u8[c] = U8(value);
+			}
+			else if (method == kWordLeft || method == kWordRight)
+				dst_u16[c] = U16(value);
+			else
+				dst_u32[c] = value;
+		}
+
+		// adjust offset/length
+		access.offset = 0;
+		access.length = cells * (bits / 8) / int(sizeof(IB));
+	}
+
+
+	// components of IB to allocate for a line of count components, packing into cells may take
+	// more room than the components
+	template <typename IB, int BITDEPTH>
+	inline int PackedLineLength(const Packing packing, const int count)
+	{
+		const int packed = int((Header::PackedLineByteCount(BITDEPTH, packing, count) + sizeof(IB) - 1) / sizeof(IB));
+		return std::max(count, packed) + 1;
+	}
+
+
+
+	inline R32 EncodeSource(const R32 *src, const int i)
+	{
+		return src[i];
+	}
+
+
+	inline R32 EncodeSource(const R16 *src, const int i)
+	{
+		return HalfToFloat(src[i].bits);
+	}
+
+
+	// printing density code values of count linear light components, the loop has no branches
+	// so that the compiler vectorizes it for float components
+	template <typename SRC>
+	inline void EncodeComponents(const SRC *src, U32 *codes, const int count, const LogEncoding *encoding)
+	{
+		for (int i = 0; i < count; i++)
+			codes[i] = encoding->Encode(EncodeSource(src, i));
+	}
+
+
+	// printing density code values of the next chunk of at most ENCODE_CHUNK components starting
+	// at first, whole chunks have a fixed count for the compiler to vectorize them at -O2 as well,
+	// returns the number of components encoded
+	template <typename SRC>
+	inline int EncodeChunk(const SRC *src, U32 *codes, const int first, const int count, const LogEncoding *encoding)
+	{
+		const int n = std::min(ENCODE_CHUNK, count - first);
+		if (n == ENCODE_CHUNK)
+			EncodeComponents(src + first, codes, ENCODE_CHUNK, encoding);
+		else
+			EncodeComponents(src + first, codes, n, encoding);
+		return n;
+	}
+
+
+	// encode a line of count linear light components as printing density and pack the code values
+	// into dst in the same pass, returns the number of U32 words or 0 if the packing is not handled
+	template <typename SRC, int BITDEPTH>
+	int EncodePackedLine(const SRC *src, U32 *dst, const int count, const Packing packing, const LogEncoding *encoding)
+	{
+		int words = 0;
+		U32 codes[ENCODE_CHUNK];
+
+		if (packing == cineon::kPacked && (BITDEPTH == 10 || BITDEPTH == 12))
+		{
+			// the components follow each other from the least significant bit
+			U64 bits = 0;
+			int used = 0;
+			for (int first = 0; first < count; )
+			{
+				const int n = EncodeChunk(src, codes, first, count, encoding);
+				for (int i = 0; i < n; i++)
+				{
+					bits |= U64(codes[i]) << used;
+					used += BITDEPTH;
+					if (used >= 32)
+					{
+						dst[words++] = U32(bits);
+						bits >>= 32;
+						used -= 32;
+					}
+				}
+				first += n;
+			}
+			if (used)
+				dst[words++] = U32(bits);
+		}
+		else if ((packing == cineon::kLongWordLeft || packing == cineon::kLongWordRight) && BITDEPTH == 10)
+		{
+			// three components to a word, the first in the most significant bits, chunks hold
+			// whole words but the last one
+			const int pad = (packing == cineon::kLongWordLeft ? 2 : 0);
+			for (int first = 0; first < count; )
+			{
+				const int n = EncodeChunk(src, codes, first, count, encoding);
+				for (int i = 0; i < n; i += 3)
+				{
+					U32 word = codes[i] << (20 + pad);
+					if (i + 1 < n)
+						word |= codes[i + 1] << (10 + pad);
+					if (i + 2 < n)
+						word |= codes[i + 2] << pad;
+					dst[words++] = word;
+				}
+				first += n;
+			}
+		}
+
+		return words;
+	}
+
+
+	// encode a line of linear light components as printing density code values in the most
+	// significant bits of IB, to be packed afterwards
+	template <typename IB, typename SRC, int BITDEPTH>
+	void EncodeLine(const SRC *src, IB *dst, const int count, const LogEncoding *encoding)
+	{
+		const int shift = sizeof(IB) * 8 - BITDEPTH;
+		U32 codes[ENCODE_CHUNK];
+		for (int first = 0; first < count; )
+		{
+			const int n = EncodeChunk(src, codes, first, count, encoding);
+			for (int i = 0; i < n; i++)
+				dst[first + i] = IB(codes[i] << shift);
+			first += n;
+		}
+	}
+
+
+	// convert and pack a single line of count components
+	// returns the buffer holding the line ready to be written, bufaccess describes the valid part of it
+	// floating point lines are encoded as printing density when an encoding is given
+	template <typename IB, int BITDEPTH, bool SAMEBUFTYPE>
+	IB *PackLine(DataSize src_size, unsigned char *src_line, IB *dst, const int count, const Packing packing,
+					const bool reverse, const LogEncoding *encoding, BufferAccess &bufaccess)
+	{
+		IB *src;
+
+		bufaccess.offset = 0;
+		bufaccess.length = count;
+
+		// linear light to printing density
+		if (encoding && BITDEPTH <= 16 && (src_size == cineon::kFloat || src_size == cineon::kHalf))
+		{
+			// packed in the same pass
+			int words;
+			if (src_size == cineon::kFloat)
+				words = EncodePackedLine<R32, BITDEPTH>(reinterpret_cast<R32 *>(src_line), reinterpret_cast<U32 *>(dst), count, packing, encoding);
+			else
+				words = EncodePackedLine<R16, BITDEPTH>(reinterpret_cast<R16 *>(src_line), reinterpret_cast<U32 *>(dst), count, packing, encoding);
+			if (words)
+			{
+				bufaccess.length = words * sizeof(U32) / sizeof(IB);
+				return dst;
+			}
+
+			// code values are packed below
+			if (src_size == cineon::kFloat)
+				EncodeLine<IB, R32, BITDEPTH>(reinterpret_cast<R32 *>(src_line), dst, count, encoding);
+			else
+				EncodeLine<IB, R16, BITDEPTH>(reinterpret_cast<R16 *>(src_line), dst, count, encoding);
+			src = dst;
+		}
+		// copy buffer if need to promote data types from src to destination
+		else if (!SAMEBUFTYPE)
+		{
+			src = dst;
+			CopyWriteBuffer<IB>(src_size, src_line, dst, count);
+		}
+		else
+			// not a copy, access source
+			src = reinterpret_cast<IB*>(src_line);
+
+		// components stored in cells, the 10-bit ones filling longwords three at a time are packed below
+		if (Header::PackingCellBits(BITDEPTH, packing) && !(BITDEPTH == 10 && (packing == cineon::kLongWordLeft || packing == cineon::kLongWordRight)))
+		{
+			WritePackedCells<IB, BITDEPTH>(src, dst, count, packing, bufaccess);
+			return dst;
+		}
+
+		// if 10 or 12 bit, pack
+		if (BITDEPTH == 10)
+		{
+			if (packing == cineon::kPacked)
+			{
+				WritePackedMethod<IB, BITDEPTH>(src, dst, count, reverse, bufaccess);
+				return dst;
+			}
+			else if (packing == cineon::kLongWordLeft)
+			{
+				WritePackedMethodAB_10bit<IB, cineon::kLongWordLeft>(src, dst, count, reverse, bufaccess);
+				return dst;
+			}
+			else if (packing == cineon::kLongWordRight)
+			{
+				WritePackedMethodAB_10bit<IB, cineon::kLongWordRight>(src, dst, count, reverse, bufaccess);
+				return dst;
+			}
+		}
+		else if (BITDEPTH == 12)
+		{
+			if (packing == cineon::kPacked)
+			{
+				WritePackedMethod<IB, BITDEPTH>(src, dst, count, reverse, bufaccess);
+				return dst;
+			}
+			// outside of the packing methods, 12-bit components fill the most significant bits of a word
+		}
+
+		return src;
+	}
+
+
 	template <typename IB, int BITDEPTH, bool SAMEBUFTYPE>
 	int WriteBuffer(OutStream *fd, DataSize src_size, void *src_buf, const U32 width, const U32 height, const int noc, const Packing packing,
-					const bool reverse, const int eolnPad, char *blank, bool &status)
+					const bool reverse, const int eolnPad, char *blank, const LogEncoding *encoding, const R32 *matrix, bool &status)
 	{
 		int fileOffset = 0;
 
 		// buffer access parameters
 		BufferAccess bufaccess;
-		bufaccess.offset = 0;
-		bufaccess.length = width * noc;
 
 		// allocate one line
-		IB *src;
-		IB *dst = new IB[(width * noc) + 1];
+		IB *dst = new IB[PackedLineLength<IB, BITDEPTH>(packing, width * noc)];
+
+		// image buffer
+		unsigned char *imageBuf = reinterpret_cast<unsigned char*>(src_buf);
+		const int bytes = Header::DataSizeByteCount(src_size);
+
+		// the colour matrix is applied to a copy of each line, the image buffer stays as it is
+		unsigned char *matrixLine = (matrix ? new unsigned char[width * noc * bytes] : 0);
 
 		// each line in the buffer
 		for (U32 h = 0; h < height; h++)
 		{
-			// image buffer
-			unsigned char *imageBuf = reinterpret_cast<unsigned char*>(src_buf);
-			const int bytes = Header::DataSizeByteCount(src_size);
-
-			// copy buffer if need to promote data types from src to destination
-			if (!SAMEBUFTYPE)
+			unsigned char *src_line = imageBuf + (h * width * noc * bytes);
+			if (matrix)
 			{
-				src = dst;
-				CopyWriteBuffer<IB>(src_size, (imageBuf+(h*width*noc*bytes)+(h*eolnPad)), dst, (width*noc));
+				ApplyMatrix(src_size, src_line, matrixLine, width, noc, matrix);
+				src_line = matrixLine;
 			}
-			else
-				// not a copy, access source
-				src = reinterpret_cast<IB*>(imageBuf + (h * width * noc * bytes) + (h*eolnPad));
 
-			// if 10 or 12 bit, pack
-			if (BITDEPTH == 10)
-			{
-				if (packing == cineon::kPacked)
-				{
-					WritePackedMethod<IB, BITDEPTH>(src, dst, (width*noc), reverse, bufaccess);
-				}
-				/*else if (packing == kFilledMethodA)
-				{
-					WritePackedMethodAB_10bit<IB, cineon::kFilledMethodA>(src, dst, (width*noc), reverse, bufaccess);
-				}
-				else // if (packing == cineon::kFilledMethodB)
-				{
-					WritePackedMethodAB_10bit<IB, cineon::kFilledMethodB>(src, dst, (width*noc), reverse, bufaccess);
-				}*/
-			}
-			else if (BITDEPTH == 12)
-			{
-				if (packing == cineon::kPacked)
-				{
-					WritePackedMethod<IB, BITDEPTH>(src, dst, (width*noc), reverse, bufaccess);
-				}
-				/*else if (packing == cineon::kFilledMethodB)
-				{
-					// shift 4 MSB down, so 0x0f00 would become 0x00f0
-					for (int w = 0; w < bufaccess.length; w++)
-						dst[w] = src[bufaccess.offset+w] >> 4;
-					bufaccess.offset = 0;
-				}*/
-				// a bitdepth of 12 by default is packed with cineon::kFilledMethodA
-				// assumes that either a copy or rle was required
-				// otherwise this routine should not be called with:
-				//     12-bit Method A with the source buffer data type is kWord
-			}
+			IB *line = PackLine<IB, BITDEPTH, SAMEBUFTYPE>(src_size, src_line, dst, (width*noc), packing, reverse, encoding, bufaccess);
 
 			// write line
 			fileOffset += (bufaccess.length * sizeof(IB));
-			if (fd->Write(dst+bufaccess.offset, (bufaccess.length * sizeof(IB))) == false)
+			if (fd->Write(line+bufaccess.offset, (bufaccess.length * sizeof(IB))) == false)
 			{
 				status = false;
 				break;
@@ -321,72 +567,175 @@ namespace cineon
 
 		}
 
-		// done with buffer
+		// done with buffers
 		delete [] dst;
+		delete [] matrixLine;
 
 		return fileOffset;
 	}
 
 
+	// convert and pack the lines [first, last) of the image into band, each line followed by its padding
+	// returns the number of bytes placed in band
 	template <typename IB, int BITDEPTH, bool SAMEBUFTYPE>
-	int WriteFloatBuffer(OutStream *fd, DataSize src_size, void *src_buf, const U32 width, const U32 height, const int noc, const Packing packing,
-					const int eolnPad, char *blank, bool &status)
+	int PackBand(DataSize src_size, void *src_buf, const U32 width, const U32 first, const U32 last, const int noc, const Packing packing,
+					const bool reverse, const int eolnPad, char *blank, const LogEncoding *encoding, const R32 *matrix, unsigned char *band)
 	{
-		int fileOffset = 0;
+		int bandSize = 0;
 
 		// buffer access parameters
 		BufferAccess bufaccess;
-		bufaccess.offset = 0;
-		bufaccess.length = width * noc;
 
 		// allocate one line
-		IB *src;
-		IB *dst = new IB[(width * noc)];
+		IB *dst = new IB[PackedLineLength<IB, BITDEPTH>(packing, width * noc)];
 
-		// each line in the buffer
-		for (U32 h = 0; h < height; h++)
-		{
-			// image buffer
-			unsigned char *imageBuf = reinterpret_cast<unsigned char*>(src_buf);
-			const int bytes = Header::DataSizeByteCount(src_size);
+		// image buffer
+		unsigned char *imageBuf = reinterpret_cast<unsigned char*>(src_buf);
+		const int bytes = Header::DataSizeByteCount(src_size);
 
-			// copy buffer if need to promote data types from src to destination
-			if (!SAMEBUFTYPE)
-			{
-				src = dst;
-				CopyWriteBuffer<IB>(src_size, (imageBuf+(h*width*noc*bytes)+(h*eolnPad)), dst, (width*noc));
-			}
-			else
-				// not a copy, access source
-				src = reinterpret_cast<IB*>(imageBuf + (h * width * noc * bytes) + (h*eolnPad));
+		// the colour matrix is applied to a copy of each line, the image buffer stays as it is
+		unsigned char *matrixLine = (matrix ? new unsigned char[width * noc * bytes] : 0);
 
-			// write line
-			fileOffset += (bufaccess.length * sizeof(IB));
-			if (fd->Write(dst+bufaccess.offset, (bufaccess.length * sizeof(IB))) == false)
+		for (U32 h = first; h < last; h++)
+		{
+			unsigned char *src_line = imageBuf + (h * width * noc * bytes);
+			if (matrix)
 			{
-				status = false;
-				break;
+				ApplyMatrix(src_size, src_line, matrixLine, width, noc, matrix);
+				src_line = matrixLine;
 			}
 
+			IB *line = PackLine<IB, BITDEPTH, SAMEBUFTYPE>(src_size, src_line, dst, (width*noc), packing, reverse, encoding, bufaccess);
+
+			::memcpy(band + bandSize, line + bufaccess.offset, bufaccess.length * sizeof(IB));
+			bandSize += bufaccess.length * sizeof(IB);
+
 			// end of line padding
 			if (eolnPad)
 			{
-				fileOffset += eolnPad;
-				if (fd->Write(blank, eolnPad) == false)
+				::memcpy(band + bandSize, blank, eolnPad);
+				bandSize += eolnPad;
+			}
+		}
+
+		// done with buffers
+		delete [] dst;
+		delete [] matrixLine;
+
+		return bandSize;
+	}
+
+
+	// same as WriteBuffer(), but the lines are converted and packed in bands of bandLines lines
+	// by several threads at once, each band is written out as a whole as soon as all of the
+	// bands above it have been written
+	template <typename IB, int BITDEPTH, bool SAMEBUFTYPE>
+	int WriteBufferBands(OutStream *fd, DataSize src_size, void *src_buf, const U32 width, const U32 height, const int noc, const Packing packing,
+					const bool reverse, const int eolnPad, char *blank, const LogEncoding *encoding, const R32 *matrix, const int bandLines, const int threads, bool &status)
+	{
+		int fileOffset = 0;
+
+		// room for a line, packed or not
+		const int lineSize = PackedLineLength<IB, BITDEPTH>(packing, width * noc) * sizeof(IB) + eolnPad;
+		const int bands = (height + bandLines - 1) / bandLines;
+
+#ifdef _OPENMP
+		#pragma omp parallel num_threads(threads)
+#endif
+		{
+			// each thread packs into its own band buffer
+			unsigned char *band = new unsigned char[bandLines * lineSize];
+
+#ifdef _OPENMP
+			#pragma omp for ordered schedule(static, 1)
+#endif
+			for (int b = 0; b < bands; b++)
+			{
+				const U32 first = b * bandLines;
+				const U32 last = std::min(first + bandLines, height);
+				const int bandSize = PackBand<IB, BITDEPTH, SAMEBUFTYPE>(src_size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+
+				// bands have to reach the stream in order
+#ifdef _OPENMP
+				#pragma omp ordered
+#endif
 				{
-					status = false;
-					break;
+					if (status)
+					{
+						fileOffset += bandSize;
+						if (fd->Write(band, bandSize) == false)
+							status = false;
+					}
 				}
 			}
 
+			// done with buffer
+			delete [] band;
 		}
 
-		// done with buffer
-		delete [] dst;
-
 		return fileOffset;
 	}
 
+
+	// write the image lines serially, or in parallel bands if more than one thread is allowed
+	template <typename IB, int BITDEPTH, bool SAMEBUFTYPE>
+	int WriteImageBuffer(OutStream *fd, DataSize src_size, void *src_buf, const U32 width, const U32 height, const int noc, const Packing packing,
+					const bool reverse, const int eolnPad, char *blank, const LogEncoding *encoding, const R32 *matrix, const int threads, bool &status)
+	{
+		if (threads > 1 && height > BAND_LINES)
+			return WriteBufferBands<IB, BITDEPTH, SAMEBUFTYPE>(fd, src_size, src_buf, width, height, noc, packing, reverse, eolnPad, blank, encoding, matrix, BAND_LINES, threads, status);
+		return WriteBuffer<IB, BITDEPTH, SAMEBUFTYPE>(fd, src_size, src_buf, width, height, noc, packing, reverse, eolnPad, blank, encoding, matrix, status);
+	}
+
+
+	// pack the lines [first, last) of an image of the given bit depth from a buffer of the given data size
+	// returns the number of bytes placed in band, or -1 if the bit depth is not supported
+	inline int PackImageBand(const U8 bitDepth, DataSize size, void *src_buf, const U32 width, const U32 first, const U32 last, const int noc,
+					const Packing packing, const bool reverse, const int eolnPad, char *blank, const LogEncoding *encoding, const R32 *matrix, unsigned char *band)
+	{
+		switch (bitDepth)
+		{
+		case 8:
+			if (size == cineon::kByte)
+				return PackBand<U8, 8, true>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+			return PackBand<U8, 8, false>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+
+		case 10:
+			if (size == cineon::kWord)
+				return PackBand<U16, 10, true>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+			return PackBand<U16, 10, false>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+
+		case 12:
+			if (size == cineon::kWord)
+				return PackBand<U16, 12, true>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+			return PackBand<U16, 12, false>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+
+		case 16:
+			if (size == cineon::kWord)
+				return PackBand<U16, 16, true>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+			return PackBand<U16, 16, false>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+
+		case 32:
+			if (size == cineon::kInt)
+				return PackBand<U32, 32, true>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+			return PackBand<U32, 32, false>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+
+		case 64:
+			if (size == cineon::kLongLong)
+				return PackBand<R64, 64, true>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+			return PackBand<R64, 64, false>(size, src_buf, width, first, last, noc, packing, reverse, eolnPad, blank, encoding, matrix, band);
+		}
+
+		return -1;
+	}
+
+
+	// size in bytes of a line of count components as written by PackLine(), without the end of line padding
+	inline int PackedLineSize(const U8 bitDepth, const Packing packing, const int count)
+	{
+		return int(Header::PackedLineByteCount(bitDepth, packing, count));
+	}
+
 }
 
 #endif
@@ -0,0 +1,153 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include <iostream>
+#include <string>
+#include <cstring>
+
+
+#include "Cineon.h"
+
+
+using namespace std;
+using namespace cineon;
+
+
+
+void Usage()
+{
+	cout << "usage: cineon2dpx [-b | -l] file.cin file.dpx" << endl;
+	cout << "       cineon2dpx [-b | -l] -d directory file.cin ..." << endl;
+	cout << "       converts 10-bit files filled into 32-bit words to DPX without decoding them" << endl;
+	cout << "       -b big endian output" << endl;
+	cout << "       -l little endian output" << endl;
+	cout << "       -d write each file.dpx into the directory" << endl;
+	cout << "       the byte order of each source is kept by default" << endl;
+}
+
+
+// byte order of a source file
+bool SourceByteOrder(const char *fileName, Endian &order)
+{
+	InStream img;
+	if (!img.Open(fileName))
+		return false;
+
+	Header header;
+	const bool status = header.Read(&img);
+	img.Close();
+
+	if (header.RequiresByteSwap())
+		order = (systemByteOrder == kLittleEndian ? kBigEndian : kLittleEndian);
+	else
+		order = systemByteOrder;
+	return status;
+}
+
+
+// name of the converted file in the directory
+string OutputFileName(const string &directory, const string &fileName)
+{
+	string base = fileName;
+	const string::size_type slash = base.find_last_of("/\\");
+	if (slash != string::npos)
+		base = base.substr(slash + 1);
+
+	const string::size_type dot = base.find_last_of('.');
+	if (dot != string::npos)
+		base = base.substr(0, dot);
+
+	return directory + "/" + base + ".dpx";
+}
+
+
+
+int main(int argc, char **argv)
+{
+	bool keepOrder = true;
+	Endian order = systemByteOrder;
+	const char *directory = 0;
+	int first = 1;
+
+	for (; first < argc && argv[first][0] == '-'; first++)
+	{
+		if (strcmp(argv[first], "-b") == 0)
+		{
+			keepOrder = false;
+			order = kBigEndian;
+		}
+		else if (strcmp(argv[first], "-l") == 0)
+		{
+			keepOrder = false;
+			order = kLittleEndian;
+		}
+		else if (strcmp(argv[first], "-d") == 0 && first + 1 < argc)
+			directory = argv[++first];
+		else
+		{
+			Usage();
+			return 1;
+		}
+	}
+
+	if ((directory == 0 && argc - first != 2) || (directory && argc - first < 1))
+	{
+		Usage();
+		return 1;
+	}
+
+	int failed = 0;
+	for (int i = first; i < argc; i++)
+	{
+		const string outFileName = (directory ? OutputFileName(directory, argv[i]) : string(argv[i + 1]));
+
+		if (keepOrder && !SourceByteOrder(argv[i], order))
+		{
+			cout << "Unable to read header of " << argv[i] << endl;
+			failed++;
+		}
+		else if (!ConvertToDpx(argv[i], outFileName.c_str(), order))
+		{
+			cout << "Unable to convert " << argv[i] << ", it has to be 10-bit filled into 32-bit words" << endl;
+			failed++;
+		}
+
+		if (directory == 0)
+			break;
+	}
+
+	return (failed ? 2 : 0);
+}
@@ -140,14 +140,16 @@ int main(int argc, char **argv)
 		return 4;
 	}
 
-	Block block(0, 0, cin.header.Width()-1, 0);
+	if (cin.BeginScanlines(size) == false)
+	{
+		cout << "unable to read image with component data size " << size << endl;
+		return 5;
+	}
+
 	int y;
 	for (y = 0; y < cin.header.Height(); y++)
 	{
-		block.y1 = y;
-		block.y2 = y;
-
-		if (cin.ReadBlock(buf, size, block) == false)
+		if (cin.ReadScanlines(buf, 1) != 1)
 		{
 			cout << "unable to read line " << y << " with component data size " << size << endl;
 			return 5;
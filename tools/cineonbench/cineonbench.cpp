@@ -0,0 +1,207 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#ifndef WIN32
+#include <sys/time.h>
+#endif
+
+
+#include "Cineon.h"
+#include "ReaderInternal.h"
+
+
+using namespace std;
+using namespace cineon;
+
+
+
+void Usage()
+{
+	cout << "usage: cineonbench [-i iterations] [-c cube size] file.cin" << endl;
+	cout << "       compares decoding with a fused 3D lookup table against decoding" << endl;
+	cout << "       followed by a separate pass over the frame" << endl;
+}
+
+
+// wall clock in seconds
+double Now()
+{
+#ifdef WIN32
+	return double(clock()) / CLOCKS_PER_SEC;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec + tv.tv_usec * 1.0e-6;
+#endif
+}
+
+
+// a smooth film like transform: a toe and shoulder on each channel with a little cross talk
+void MakeCube(R32 *cube, const int size)
+{
+	for (int b = 0; b < size; b++)
+	{
+		for (int g = 0; g < size; g++)
+		{
+			for (int r = 0; r < size; r++)
+			{
+				const float in[3] = { float(r) / (size - 1), float(g) / (size - 1), float(b) / (size - 1) };
+				R32 *out = cube + 3 * ((b * size + g) * size + r);
+				for (int c = 0; c < 3; c++)
+				{
+					const float v = 0.9f * in[c] + 0.05f * (in[(c + 1) % 3] + in[(c + 2) % 3]);
+					out[c] = v * v * (3.0f - 2.0f * v);
+				}
+			}
+		}
+	}
+}
+
+
+
+int main(int argc, char **argv)
+{
+	int iterations = 10;
+	int cubeSize = 33;
+	const char *fileName = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+			iterations = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+			cubeSize = atoi(argv[++i]);
+		else if (fileName == 0 && argv[i][0] != '-')
+			fileName = argv[i];
+		else
+		{
+			Usage();
+			return 1;
+		}
+	}
+
+	if (fileName == 0 || iterations < 1 || cubeSize < 2)
+	{
+		Usage();
+		return 1;
+	}
+
+	// open the image
+	InStream img;
+	if (!img.Open(fileName))
+	{
+		cout << "Unable to open file " << fileName << endl;
+		return 1;
+	}
+
+	Reader cin;
+	cin.SetInStream(&img);
+	if (!cin.ReadHeader())
+	{
+		cout << "Unable to read header" << endl;
+		return 2;
+	}
+
+	const int width = cin.header.Width();
+	const int height = cin.header.Height();
+	const int noc = cin.header.NumberOfElements();
+	if (noc < 3)
+	{
+		cout << "The image needs at least three components" << endl;
+		return 2;
+	}
+
+	R32 *cube = new R32[3 * cubeSize * cubeSize * cubeSize];
+	MakeCube(cube, cubeSize);
+
+	const size_t count = size_t(width) * height * noc;
+	R32 *separate = new R32[count];
+	R32 *fused = new R32[count];
+
+	ReadOptions options;
+	options.cube = cube;
+	options.cubeSize = cubeSize;
+	Block block(0, 0, width - 1, height - 1);
+
+	// decode only
+	double start = Now();
+	for (int i = 0; i < iterations; i++)
+		cin.ReadImage(separate, kFloat);
+	const double decode = (Now() - start) / iterations;
+
+	// decode, then a pass over the frame
+	start = Now();
+	for (int i = 0; i < iterations; i++)
+	{
+		cin.ReadImage(separate, kFloat);
+		ApplyCube<R32>(separate, width * height, noc, cube, cubeSize);
+	}
+	const double twoPass = (Now() - start) / iterations;
+
+	// transform each line as it is decoded
+	start = Now();
+	for (int i = 0; i < iterations; i++)
+	{
+		if (!cin.ReadBlock(fused, kFloat, block, options))
+		{
+			cout << "Unable to read image data" << endl;
+			return 3;
+		}
+	}
+	const double onePass = (Now() - start) / iterations;
+
+	// both have to give the same pixels
+	double difference = 0.0;
+	for (size_t i = 0; i < count; i++)
+		difference = max(difference, fabs(double(separate[i]) - fused[i]));
+
+	cout << width << "x" << height << " " << noc << " components, " << cubeSize << "^3 cube, "
+		 << iterations << " iterations" << endl;
+	cout << "decode only:          " << decode * 1000.0 << " ms/frame" << endl;
+	cout << "decode, then 3D LUT:  " << twoPass * 1000.0 << " ms/frame" << endl;
+	cout << "decode with 3D LUT:   " << onePass * 1000.0 << " ms/frame" << endl;
+	cout << "largest difference:   " << difference << endl;
+
+	delete [] fused;
+	delete [] separate;
+	delete [] cube;
+
+	return 0;
+}
@@ -0,0 +1,165 @@
+// -*- mode: C++; tab-width: 4 -*-
+// vi: ts=4
+
+/*
+ * Copyright (c) 2010, Patrick Palmer and Leszek Godlewski.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   - Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *   - Neither the name of Patrick Palmer nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+#include "Cineon.h"
+
+
+using namespace std;
+using namespace cineon;
+
+
+
+void Usage()
+{
+	cout << "usage: cineonupdate [options] file.cin ..." << endl;
+	cout << "       changes header fields of a sequence of files in place, the files in sequence order" << endl;
+	cout << "       -n                set the file name field to the name of each file" << endl;
+	cout << "       -p first[,step]   number the frame positions from first, step apart" << endl;
+	cout << "       -e edgecode       film edge code of the first file, 16 digits: manufacturer, type," << endl;
+	cout << "                         perfs offset, 6 digit prefix and 4 digit count" << endl;
+	cout << "       -E perfs[,count]  perfs from one file to the next and from one count to the next (64)" << endl;
+	cout << "       -i id             frame identification" << endl;
+	cout << "       -s slate          slate information" << endl;
+	cout << "       -f format         format string" << endl;
+	cout << "       -l label          label text" << endl;
+	cout << "       -r rate           frame rate of the original" << endl;
+}
+
+
+// the digits of a film edge code, as printed by Header::FilmEdgeCode()
+bool ParseEdgeCode(const char *str, HeaderUpdate &update)
+{
+	if (strlen(str) != 16 || strspn(str, "0123456789") != 16)
+		return false;
+
+	unsigned int mfg, type, perfs, prefix, count;
+	if (sscanf(str, "%2u%2u%2u%6u%4u", &mfg, &type, &perfs, &prefix, &count) != 5)
+		return false;
+
+	update.filmEdgeCode = true;
+	update.filmManufacturingIdCode = U8(mfg);
+	update.filmType = U8(type);
+	update.perfsOffset = U8(perfs);
+	update.prefix = prefix;
+	update.count = count;
+	return true;
+}
+
+
+
+int main(int argc, char **argv)
+{
+	HeaderUpdate update;
+	int first = 1;
+
+	for (; first < argc && argv[first][0] == '-'; first++)
+	{
+		const char *opt = argv[first];
+		const bool value = (first + 1 < argc);
+
+		if (strcmp(opt, "-n") == 0)
+			update.fileName = true;
+		else if (strcmp(opt, "-p") == 0 && value)
+		{
+			int step = 1;
+			unsigned int position;
+			if (sscanf(argv[++first], "%u,%d", &position, &step) < 1)
+			{
+				Usage();
+				return 1;
+			}
+			update.framePosition = true;
+			update.firstFramePosition = position;
+			update.framePositionStep = step;
+		}
+		else if (strcmp(opt, "-e") == 0 && value)
+		{
+			if (!ParseEdgeCode(argv[++first], update))
+			{
+				Usage();
+				return 1;
+			}
+		}
+		else if (strcmp(opt, "-E") == 0 && value)
+		{
+			if (sscanf(argv[++first], "%d,%d", &update.perfsPerFrame, &update.perfsPerCount) < 1)
+			{
+				Usage();
+				return 1;
+			}
+		}
+		else if (strcmp(opt, "-i") == 0 && value)
+			update.frameId = argv[++first];
+		else if (strcmp(opt, "-s") == 0 && value)
+			update.slateInfo = argv[++first];
+		else if (strcmp(opt, "-f") == 0 && value)
+			update.format = argv[++first];
+		else if (strcmp(opt, "-l") == 0 && value)
+			update.labelText = argv[++first];
+		else if (strcmp(opt, "-r") == 0 && value)
+			update.frameRate = R32(atof(argv[++first]));
+		else
+		{
+			Usage();
+			return 1;
+		}
+	}
+
+	const int count = argc - first;
+	if (count < 1)
+	{
+		Usage();
+		return 1;
+	}
+
+	bool *status = new bool[count];
+	const int updated = UpdateHeaders(argv + first, count, update, status);
+
+	for (int i = 0; i < count; i++)
+	{
+		if (!status[i])
+			cout << "Unable to update " << argv[first + i] << endl;
+	}
+	delete [] status;
+
+	return (updated == count ? 0 : 2);
+}